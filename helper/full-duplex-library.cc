@@ -8,6 +8,14 @@
 
 
 #include "full-duplex-library.h"
+#include "ns3/full-wifi-net-device.h"
+#include "ns3/full-regular-wifi-mac.h"
+#include "ns3/full-yans-wifi-phy.h"
+#include "ns3/full-nist-error-rate-model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
 
 using namespace ns3;
 
@@ -110,10 +118,373 @@ GetDistanceList (NodeContainer nodes, Ptr<Node> node)
           distanceList.push_back(std::make_pair (*it, GetDistance (node, *it)));
       }
     // sort the new node list by distance
-    std::sort(distanceList.begin(), distanceList.end(), sort_pred());
+    std::sort(distanceList.begin(), distanceList.end(), ::sort_pred());
     return distanceList;
 }
 
+namespace {
+
+// success rates are tabulated over this SINR range, in dB
+const double CONFLICT_MIN_SINR_DB = -10.0;
+const double CONFLICT_MAX_SINR_DB = 40.0;
+const double CONFLICT_SINR_STEP_DB = 0.1;
+
+struct ConflictCandidate
+{
+  ConflictCandidate (uint32_t dst, double p)
+    : dst (dst), priority (p) {}
+  uint32_t dst;
+  double priority;
+};
+
+// the inputs of the candidate evaluation, and its result
+struct ConflictMapData
+{
+  uint32_t nNodes;
+  std::vector<std::pair<uint32_t, uint32_t> > flows;  // (src, x) as node indexes
+  std::vector<int32_t> powerRow;   // node index -> row of rxPowerW, or -1
+  std::vector<double> rxPowerW;    // rxPowerW[row * nNodes + d]
+  double noiseW;
+  double exposedThreshold;
+  double minProbability;
+  std::vector<double> successRate; // success rate per CONFLICT_SINR_STEP_DB
+  std::vector<std::vector<ConflictCandidate> > candidates;  // per flow
+};
+
+double
+GetConflictSuccessRate (const ConflictMapData &data, double sinrDb)
+{
+  if (sinrDb < CONFLICT_MIN_SINR_DB)
+    {
+      return 0;
+    }
+  // round down, to never overestimate the success rate
+  uint32_t i = static_cast<uint32_t> ((sinrDb - CONFLICT_MIN_SINR_DB) / CONFLICT_SINR_STEP_DB);
+  return data.successRate[std::min<uint32_t> (i, data.successRate.size () - 1)];
+}
+
+void
+FindConflictCandidates (ConflictMapData *data)
+{
+  for (uint32_t f = 0; f < data->flows.size (); f++)
+    {
+      uint32_t src = data->flows[f].first;
+      uint32_t x = data->flows[f].second;
+      const double *fromX = &data->rxPowerW[data->powerRow[x] * data->nNodes];
+      const double *fromSrc = &data->rxPowerW[data->powerRow[src] * data->nNodes];
+      std::vector<ConflictCandidate> &out = data->candidates[f];
+      for (uint32_t d = 0; d < data->nNodes; d++)
+        {
+          if (d == src || d == x)
+            {
+              continue;
+            }
+          double sinrDb = 10 * std::log10 (fromX[d] / (fromSrc[d] + data->noiseW));
+          if (sinrDb < data->exposedThreshold)
+            {
+              continue;
+            }
+          double p = GetConflictSuccessRate (*data, sinrDb);
+          if (p < data->minProbability)
+            {
+              continue;
+            }
+          out.push_back (ConflictCandidate (d, 1 - p));
+        }
+    }
+}
+
+Ptr<FullWifiNetDevice>
+GetFullWifiNetDevice (Ptr<Node> node)
+{
+  for (uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<FullWifiNetDevice> device = DynamicCast<FullWifiNetDevice> (node->GetDevice (i));
+      if (device != 0)
+        {
+          return device;
+        }
+    }
+  return 0;
+}
+
+// FNV-1a of the position file, or 0 if it cannot be read
+uint64_t
+GetFileFingerprint (std::string fileName)
+{
+  std::ifstream in (fileName.c_str (), std::ios::binary);
+  if (!in)
+    {
+      return 0;
+    }
+  uint64_t hash = 14695981039346656037ULL;
+  char c;
+  while (in.get (c))
+    {
+      hash ^= static_cast<unsigned char> (c);
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+// Append the type and the attribute values of object, and of the objects
+// it points to, so that a change of any of them changes the cache key.
+void
+AppendObjectKey (std::ostream &os, Ptr<const Object> object, uint32_t depth)
+{
+  if (object == 0)
+    {
+      os << "0";
+      return;
+    }
+  os << object->GetInstanceTypeId ().GetName () << "{";
+  for (TypeId tid = object->GetInstanceTypeId (); ; tid = tid.GetParent ())
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+            {
+              continue;
+            }
+          Ptr<AttributeValue> value = info.checker->Create ();
+          object->GetAttribute (info.name, *value);
+          os << " " << info.name << "=";
+          // pointers would serialize as addresses: follow them instead
+          const PointerValue *pointer = dynamic_cast<const PointerValue *> (PeekPointer (value));
+          const ObjectPtrContainerValue *container = dynamic_cast<const ObjectPtrContainerValue *> (PeekPointer (value));
+          // doubles serialize with 6 digits only
+          const DoubleValue *real = dynamic_cast<const DoubleValue *> (PeekPointer (value));
+          if (real != 0)
+            {
+              os << real->Get ();
+            }
+          else if (pointer != 0)
+            {
+              if (depth > 0)
+                {
+                  AppendObjectKey (os, pointer->GetObject (), depth - 1);
+                }
+            }
+          else if (container != 0)
+            {
+              for (ObjectPtrContainerValue::Iterator it = container->Begin (); it != container->End (); ++it)
+                {
+                  if (depth > 0)
+                    {
+                      AppendObjectKey (os, it->second, depth - 1);
+                    }
+                }
+            }
+          else
+            {
+              std::string serialized = value->SerializeToString (info.checker);
+              std::replace (serialized.begin (), serialized.end (), '\n', ' ');
+              os << serialized;
+            }
+        }
+      if (tid == tid.GetParent ())
+        {
+          break;
+        }
+    }
+  os << " }";
+}
+
+bool
+ReadConflictMapCache (std::string cacheFileName, std::string key, ConflictMapData *data)
+{
+  std::ifstream in (cacheFileName.c_str ());
+  std::string line;
+  if (!in || !std::getline (in, line) || line != key)
+    {
+      return false;
+    }
+  uint32_t f, d;
+  double priority;
+  while (in >> f >> d >> priority)
+    {
+      if (f >= data->candidates.size () || d >= data->nNodes)
+        {
+          return false;
+        }
+      data->candidates[f].push_back (ConflictCandidate (d, priority));
+    }
+  return in.eof ();
+}
+
+void
+WriteConflictMapCache (std::string cacheFileName, std::string key, const ConflictMapData &data)
+{
+  std::ofstream out (cacheFileName.c_str ());
+  if (!out)
+    {
+      NS_LOG_WARN ("cannot write the conflict map cache " << cacheFileName);
+      return;
+    }
+  out.precision (17);
+  out << key << "\n";
+  for (uint32_t f = 0; f < data.candidates.size (); f++)
+    {
+      for (std::vector<ConflictCandidate>::const_iterator it = data.candidates[f].begin ();
+           it != data.candidates[f].end (); ++it)
+        {
+          out << f << " " << it->dst << " " << it->priority << "\n";
+        }
+    }
+}
+
+} // anonymous namespace
+
+void
+SetDuplexConflictMap (NodeContainer nodes,
+    std::vector<std::pair<Ptr<Node>,Ptr<Node> > > flowList,
+    Ptr<PropagationLossModel> lossModel,
+    double txPower,
+    double exposedThreshold,
+    double minProbability,
+    std::string phyMode,
+    uint32_t packetSize,
+    std::string positionFileName)
+{
+  ConflictMapData data;
+  data.nNodes = nodes.GetN ();
+  data.exposedThreshold = exposedThreshold;
+  data.minProbability = minProbability;
+
+  std::map<uint32_t, uint32_t> indexOf;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      indexOf[nodes.Get (i)->GetId ()] = i;
+    }
+  for (uint32_t f = 0; f < flowList.size (); f++)
+    {
+      NS_ASSERT (indexOf.find (flowList[f].first->GetId ()) != indexOf.end ());
+      NS_ASSERT (indexOf.find (flowList[f].second->GetId ()) != indexOf.end ());
+      data.flows.push_back (std::make_pair (indexOf[flowList[f].first->GetId ()],
+                                            indexOf[flowList[f].second->GetId ()]));
+    }
+  data.candidates.resize (data.flows.size ());
+
+  // the noise and the error rate model of the PHY of the first node
+  double noiseFigureDb = 7;
+  Ptr<FullErrorRateModel> errorModel;
+  Ptr<FullWifiNetDevice> device = data.nNodes > 0 ? GetFullWifiNetDevice (nodes.Get (0)) : 0;
+  Ptr<FullYansWifiPhy> phy = device != 0 ? DynamicCast<FullYansWifiPhy> (device->GetPhy ()) : 0;
+  if (phy != 0)
+    {
+      noiseFigureDb = phy->GetRxNoiseFigure ();
+      errorModel = phy->GetErrorRateModel ();
+    }
+  if (errorModel == 0)
+    {
+      errorModel = CreateObject<FullNistErrorRateModel> ();
+    }
+
+  // every input of the computation but the positions, which are covered
+  // by the fingerprint of the position file
+  std::ostringstream key;
+  key.precision (17);
+  key << "# conflict map " << GetFileFingerprint (positionFileName)
+      << " " << txPower << " " << exposedThreshold << " " << minProbability
+      << " " << phyMode << " " << packetSize << " " << noiseFigureDb
+      << " " << data.nNodes << " loss ";
+  AppendObjectKey (key, lossModel, 4);
+  key << " error ";
+  AppendObjectKey (key, errorModel, 4);
+  key << " flows";
+  for (uint32_t f = 0; f < data.flows.size (); f++)
+    {
+      key << " " << data.flows[f].first << ":" << data.flows[f].second;
+    }
+  std::string cacheFileName;
+  if (!positionFileName.empty () && GetFileFingerprint (positionFileName) != 0)
+    {
+      cacheFileName = positionFileName + ".conflict";
+    }
+
+  if (cacheFileName.empty () || !ReadConflictMapCache (cacheFileName, key.str (), &data))
+    {
+      for (uint32_t f = 0; f < data.candidates.size (); f++)
+        {
+          data.candidates[f].clear ();
+        }
+
+      FullWifiMode mode (phyMode);
+      static const double BOLTZMANN = 1.3803e-23;
+      data.noiseW = std::pow (10.0, noiseFigureDb / 10.0) * BOLTZMANN * 290.0 * mode.GetBandwidth ();
+      for (double sinrDb = CONFLICT_MIN_SINR_DB; sinrDb <= CONFLICT_MAX_SINR_DB + 1e-9;
+           sinrDb += CONFLICT_SINR_STEP_DB)
+        {
+          double sinr = std::pow (10.0, sinrDb / 10.0);
+          data.successRate.push_back (errorModel->GetChunkSuccessRate (mode, sinr, packetSize * 8));
+        }
+
+      // received powers from every transmitter which takes part in a flow
+      data.powerRow.assign (data.nNodes, -1);
+      uint32_t nRows = 0;
+      for (uint32_t f = 0; f < data.flows.size (); f++)
+        {
+          uint32_t ends[2] = { data.flows[f].first, data.flows[f].second };
+          for (uint32_t e = 0; e < 2; e++)
+            {
+              if (data.powerRow[ends[e]] >= 0)
+                {
+                  continue;
+                }
+              data.powerRow[ends[e]] = nRows++;
+              for (uint32_t d = 0; d < data.nNodes; d++)
+                {
+                  double dbm = CalculateSnr (nodes.Get (ends[e]), nodes.Get (d), lossModel, txPower);
+                  data.rxPowerW.push_back (std::pow (10.0, (dbm - 30) / 10.0));
+                }
+            }
+        }
+
+      FindConflictCandidates (&data);
+
+      if (!cacheFileName.empty ())
+        {
+          WriteConflictMapCache (cacheFileName, key.str (), data);
+        }
+    }
+
+  // one ForwardQueue per node, with one ForwardMap per transmitter to it
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < data.nNodes; i++)
+    {
+      Ptr<FullWifiNetDevice> device = GetFullWifiNetDevice (nodes.Get (i));
+      addresses.push_back (device != 0 ? Mac48Address::ConvertFrom (device->GetAddress ()) : Mac48Address ());
+    }
+  std::vector<Ptr<ForwardQueue> > queues (data.nNodes);
+  for (uint32_t f = 0; f < data.flows.size (); f++)
+    {
+      uint32_t src = data.flows[f].first;
+      uint32_t x = data.flows[f].second;
+      if (queues[x] == 0)
+        {
+          queues[x] = CreateObject<ForwardQueue> ();
+        }
+      std::vector<ForwardItem> items;
+      for (std::vector<ConflictCandidate>::const_iterator it = data.candidates[f].begin ();
+           it != data.candidates[f].end (); ++it)
+        {
+          items.push_back (ForwardItem (addresses[it->dst], it->priority));
+        }
+      queues[x]->AddForwardMap (ForwardMap (addresses[src], items));
+    }
+  for (uint32_t i = 0; i < data.nNodes; i++)
+    {
+      Ptr<FullWifiNetDevice> device = GetFullWifiNetDevice (nodes.Get (i));
+      Ptr<FullRegularWifiMac> mac = device != 0 ? DynamicCast<FullRegularWifiMac> (device->GetMac ()) : 0;
+      if (mac == 0)
+        {
+          continue;
+        }
+      mac->SetForwardQueue (queues[i] != 0 ? queues[i] : CreateObject<ForwardQueue> ());
+    }
+}
+
 ApplicationContainer
 SetupPacketReceive (Ptr<Node> node)
 {
@@ -355,6 +726,17 @@ NodeLog::Print (Time duration, bool pretty)
   return out.str ();
 }
 
+void
+SetDuplexConflictMap (Ptr<DuplexExperiment> d, NodeContainer nodes,
+    std::vector<std::pair<Ptr<Node>,Ptr<Node> > > flowList,
+    Ptr<PropagationLossModel> lossModel)
+{
+  SetDuplexConflictMap (nodes, flowList, lossModel, d->txPower,
+                        d->exposedThreshold, d->minProbability,
+                        d->phyMode, d->packetSize,
+                        d->loadPositions ? d->positionFileName : "");
+}
+
 CommandLine
 CreateCommandLine (Ptr<DuplexExperiment> d)
 {
@@ -19,6 +19,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/full-wifi-mode.h"
 
 #include <vector>
 #include <fstream>
@@ -37,12 +38,35 @@ GetPosition (Ptr<Node> node);
 double
 CalculateSnr(Ptr<Node> src, Ptr<Node> dst, Ptr<PropagationLossModel> lossModel, double txPower);
 
-//void
-//SetDuplexConflictMap (NodeContainer nodes,
-//    std::vector<std::pair<Ptr<Node>,Ptr<Node> > > flowList,
-//    Ptr<PropagationLossModel> lossModel,
-//    double txPower);
-//
+/**
+ * Compute the full-duplex forwarding candidates of every node and install
+ * them as the ForwardQueue of its FullRegularWifiMac.
+ *
+ * For every flow (src, x) and every other node d, x may send to d while it
+ * receives from src if the SINR of x at d, with src as the interferer, is
+ * at least exposedThreshold (dB) and a packetSize-byte frame sent in
+ * phyMode then succeeds with probability at least minProbability. The
+ * candidates are ordered by decreasing success probability.
+ *
+ * The received powers from every transmitter of a flow and the success
+ * rates over a 0.1 dB SINR grid are computed once, so that evaluating the
+ * candidates only reads tables. If positionFileName is not empty, the map
+ * is cached next to it and read back as long as the position file, the
+ * parameters, the noise figure of the PHY and the types and attribute
+ * values of the loss and error rate models are the same. With a random loss model, the cache
+ * keeps the map drawn by the first run.
+ */
+void
+SetDuplexConflictMap (NodeContainer nodes,
+    std::vector<std::pair<Ptr<Node>,Ptr<Node> > > flowList,
+    Ptr<PropagationLossModel> lossModel,
+    double txPower,
+    double exposedThreshold,
+    double minProbability,
+    std::string phyMode,
+    uint32_t packetSize,
+    std::string positionFileName = "");
+
 //void
 //SetSwConflictMap (NodeContainer nodes,
 //    std::vector<std::pair<Ptr<Node>, Ptr<Node> > > flowList,
@@ -181,6 +205,8 @@ public:
     secondaryPacket = false;
     busytone = false;
     phyMode  = "OfdmRate6Mbps";
+    exposedThreshold = 10; // in dB
+    minProbability = 0.9;
 
     uplinkRate = "6Mbps";
     downlinkRate = "6Mbps";
@@ -246,4 +272,13 @@ public:
 
 CommandLine CreateCommandLine(Ptr<DuplexExperiment> d);
 
+/**
+ * SetDuplexConflictMap with the parameters of the experiment, cached next
+ * to its position file when the positions were loaded from it.
+ */
+void
+SetDuplexConflictMap (Ptr<DuplexExperiment> d, NodeContainer nodes,
+    std::vector<std::pair<Ptr<Node>,Ptr<Node> > > flowList,
+    Ptr<PropagationLossModel> lossModel);
+
 #endif  /*  FULL_DUPLEX_LIBRARY  */
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "full-ctrl-frame-factory.h"
+#include "full-wifi-mac-trailer.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/* offsets of the fields patched into the serialized templates */
+static const uint32_t DURATION_OFFSET = 2;
+static const uint32_t ADDR1_OFFSET = 4;
+static const uint32_t ADDR2_OFFSET = 10;
+static const uint32_t ADDR3_OFFSET = 16;
+static const uint32_t SEQUENCE_CONTROL_OFFSET = 22;
+
+static void
+WriteU16 (uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = value & 0xff;
+  buffer[1] = (value >> 8) & 0xff;
+}
+
+FullCtrlFrameFactory::FullCtrlFrameFactory ()
+{
+  Build (FULL_WIFI_MAC_CTL_ACK);
+  Build (FULL_WIFI_MAC_CTL_CTS);
+  Build (FULL_WIFI_MAC_CTL_RTS);
+  Build (FULL_WIFI_MAC_BUSY_TONE);
+}
+
+uint32_t
+FullCtrlFrameFactory::GetIndex (enum FullWifiMacType type)
+{
+  switch (type)
+    {
+    case FULL_WIFI_MAC_CTL_ACK:
+      return ACK;
+    case FULL_WIFI_MAC_CTL_CTS:
+      return CTS;
+    case FULL_WIFI_MAC_CTL_RTS:
+      return RTS;
+    case FULL_WIFI_MAC_BUSY_TONE:
+      return BUSY_TONE;
+    default:
+      NS_ASSERT_MSG (false, "no template for this frame type");
+      return N_TEMPLATES;
+    }
+}
+
+void
+FullCtrlFrameFactory::Build (enum FullWifiMacType type)
+{
+  Template &t = m_templates[GetIndex (type)];
+  t.header.SetType (type);
+  t.header.SetDsNotFrom ();
+  t.header.SetDsNotTo ();
+  t.header.SetNoRetry ();
+  t.header.SetNoMoreFragments ();
+  t.header.SetFragmentNumber (0);
+
+  Ptr<Packet> packet = ns3::Create<Packet> ();
+  packet->AddHeader (t.header);
+  FullWifiMacTrailer fcs;
+  packet->AddTrailer (fcs);
+  t.size = packet->GetSize ();
+  NS_ASSERT (t.size <= MAX_SIZE);
+  packet->CopyData (t.bytes, t.size);
+}
+
+const FullWifiMacHeader &
+FullCtrlFrameFactory::GetHeader (enum FullWifiMacType type) const
+{
+  return m_templates[GetIndex (type)].header;
+}
+
+Ptr<Packet>
+FullCtrlFrameFactory::Create (const FullWifiMacHeader &hdr)
+{
+  Template &t = m_templates[GetIndex (hdr.GetType ())];
+  NS_ASSERT (hdr.GetFrameControl () == t.header.GetFrameControl ());
+
+  WriteU16 (t.bytes + DURATION_OFFSET, hdr.GetRawDuration ());
+  hdr.GetAddr1 ().CopyTo (t.bytes + ADDR1_OFFSET);
+  if (hdr.IsRts () || hdr.IsBusyTone ())
+    {
+      hdr.GetAddr2 ().CopyTo (t.bytes + ADDR2_OFFSET);
+    }
+  if (hdr.IsBusyTone ())
+    {
+      hdr.GetAddr3 ().CopyTo (t.bytes + ADDR3_OFFSET);
+      WriteU16 (t.bytes + SEQUENCE_CONTROL_OFFSET, hdr.GetSequenceControl ());
+    }
+  Ptr<Packet> packet = ns3::Create<Packet> (t.bytes, t.size);
+  if (packet->BeginItem ().HasNext ())
+    {
+      // the packet metadata is enabled and recorded the bytes as payload
+      packet = ns3::Create<Packet> ();
+      packet->AddHeader (hdr);
+      FullWifiMacTrailer fcs;
+      packet->AddTrailer (fcs);
+    }
+  return packet;
+}
+
+} // namespace ns3
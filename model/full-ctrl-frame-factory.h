@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FULL_CTRL_FRAME_FACTORY_H
+#define FULL_CTRL_FRAME_FACTORY_H
+
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "ns3/mac48-address.h"
+#include "full-wifi-mac-header.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief build the fixed-layout frames sent by FullMacLow.
+ *
+ * ACK, CTS, RTS and busy tone frames always have the same frame control
+ * and the same layout. The header and the FCS trailer of each of them
+ * are serialized once, when the factory is constructed, and every new
+ * frame is made by patching the Duration/ID, address and sequence
+ * control fields of that template.
+ *
+ * The packet metadata of a frame made from the template bytes would
+ * describe a payload instead of a header and a trailer, which breaks
+ * RemoveHeader under Packet::EnableChecking and the printing of the
+ * frame in ascii traces. When the metadata is enabled, frames are
+ * therefore built with AddHeader and AddTrailer, to the same bytes.
+ */
+class FullCtrlFrameFactory
+{
+public:
+  FullCtrlFrameFactory ();
+
+  /**
+   * \param type FULL_WIFI_MAC_CTL_ACK, FULL_WIFI_MAC_CTL_CTS,
+   *        FULL_WIFI_MAC_CTL_RTS or FULL_WIFI_MAC_BUSY_TONE
+   * \return a header with the frame control of the template, to which
+   *         the caller only has to add addresses and duration
+   */
+  const FullWifiMacHeader & GetHeader (enum FullWifiMacType type) const;
+  /**
+   * \param hdr a header obtained from GetHeader and completed by the caller
+   * \return a packet holding hdr followed by the FCS trailer
+   */
+  Ptr<Packet> Create (const FullWifiMacHeader &hdr);
+
+private:
+  enum
+  {
+    ACK = 0,
+    CTS,
+    RTS,
+    BUSY_TONE,
+    N_TEMPLATES
+  };
+  /// the biggest template: a busy tone header (24 bytes) and the FCS
+  static const uint32_t MAX_SIZE = 28;
+
+  struct Template
+  {
+    FullWifiMacHeader header;
+    uint8_t bytes[MAX_SIZE];
+    uint32_t size;
+  };
+
+  static uint32_t GetIndex (enum FullWifiMacType type);
+  void Build (enum FullWifiMacType type);
+
+  Template m_templates[N_TEMPLATES];
+};
+
+} // namespace ns3
+
+#endif /* FULL_CTRL_FRAME_FACTORY_H */
@@ -66,9 +66,9 @@ private:
   {
     m_txop->NotifyChannelSwitching ();
   }
-  virtual void DoNotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+  virtual void DoNotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
   {
-    m_txop->NotifyRxStartNow (duration, packet, txMode, preamble);
+    m_txop->NotifyRxStartNow (duration, frame, txMode, preamble);
   }
   FullDcaTxop *m_txop;
 };
@@ -118,16 +118,28 @@ private:
 
 
 
+void
+ForwardMap::AddItem (const ForwardItem &newItem)
+{
+  //after the items of the same priority, as a stable sort would put it
+  std::vector<ForwardItem>::iterator it;
+  it = std::upper_bound (m_forwardQueue.begin (), m_forwardQueue.end (), newItem, sort_pred ());
+  m_forwardQueue.insert (it, newItem);
+}
+
 void
 ForwardMap::RemoveItem (Mac48Address add)
 {
-  std::list<ForwardItem>::iterator it;
-  it = m_forwardQueue.begin();
-  for ( it = m_forwardQueue.begin (); it != m_forwardQueue.end (); it++)
+  std::vector<ForwardItem>::iterator it = m_forwardQueue.begin ();
+  while (it != m_forwardQueue.end ())
     {
       if (add == (*it).add)
         {
-          m_forwardQueue.erase (it);
+          it = m_forwardQueue.erase (it);
+        }
+      else
+        {
+          it++;
         }
     }
 }
@@ -135,7 +147,7 @@ ForwardMap::RemoveItem (Mac48Address add)
 ForwardItem*
 ForwardMap::GetItem (Mac48Address add)
 {
-  std::list<ForwardItem>::iterator it;
+  std::vector<ForwardItem>::iterator it;
   for ( it = m_forwardQueue.begin (); it != m_forwardQueue.end (); it++)
     {
       if (add == (*it).add)
@@ -149,14 +161,13 @@ ForwardMap::GetItem (Mac48Address add)
 void
 ForwardMap::SortQueue ()
 {
-//  std::sort(m_forwardQueue.begin(), m_forwardQueue.end(), sort_pred());
-  m_forwardQueue.sort(sort_pred());
+  std::stable_sort (m_forwardQueue.begin (), m_forwardQueue.end (), sort_pred ());
 }
 
 void
 ForwardMap::UpdateItem (Mac48Address add, double p)
 {
-  std::list<ForwardItem>::iterator it;
+  std::vector<ForwardItem>::iterator it;
   for ( it = m_forwardQueue.begin (); it != m_forwardQueue.end (); it++)
     {
       if (add == (*it).add)
@@ -168,19 +179,31 @@ ForwardMap::UpdateItem (Mac48Address add, double p)
 }
 
 
+ForwardQueue::ForwardQueue (const std::vector<ForwardMap> &queue)
+{
+  std::vector<ForwardMap>::const_iterator it;
+  for (it = queue.begin (); it != queue.end (); it++)
+    {
+      AddForwardMap (*it);
+    }
+}
+
+void
+ForwardQueue::AddForwardMap (const ForwardMap &newItem)
+{
+  m_forwardQueue.insert (std::make_pair (newItem.GetTransmitterAddress (), newItem));
+}
+
 ForwardMap*
 ForwardQueue::GetForwardMap (Mac48Address add)
+{
+  ForwardMaps::iterator it = m_forwardQueue.find (add);
+  if (it == m_forwardQueue.end ())
     {
-        std::list<ForwardMap>::iterator it;
-        for ( it = m_forwardQueue.begin (); it != m_forwardQueue.end (); it++)
-          {
-            if (add == (*it).GetTransmitterAddress ())
-              {
-                return &(*it);
-              }
-          }
-        return 0;
+      return 0;
     }
+  return &it->second;
+}
 
 NS_OBJECT_ENSURE_REGISTERED (FullDcaTxop);
 
@@ -194,6 +217,16 @@ FullDcaTxop::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&FullDcaTxop::GetQueue),
                    MakePointerChecker<FullWifiMacQueue> ())
+    .AddAttribute ("ReturnPacketPolicy",
+                   "How to choose the return or forward packet among the packets queued for its destination.",
+                   PointerValue (),
+                   MakePointerAccessor (&FullDcaTxop::SetReturnPacketPolicy,
+                                        &FullDcaTxop::GetReturnPacketPolicy),
+                   MakePointerChecker<FullReturnPacketPolicy> ())
+    .AddTraceSource ("ReturnPacketOverlap",
+                     "The shorter over the longer of the duration of a return or forward packet "
+                     "and of what is left of the primary frame.",
+                     MakeTraceSourceAccessor (&FullDcaTxop::m_returnOverlapTrace))
   ;
   return tid;
 }
@@ -214,6 +247,7 @@ FullDcaTxop::FullDcaTxop ()
   m_enableForward = false;
 
   m_forwardQueue = new ForwardQueue();
+  m_returnPolicy = CreateObject<FullFirstReturnPacketPolicy> ();
 
 }
 
@@ -229,6 +263,8 @@ FullDcaTxop::DoDispose (void)
   m_queue = 0;
   m_low = 0;
   m_stationManager = 0;
+  m_returnPolicy = 0;
+  m_returnCandidates.clear ();
   delete m_transmissionListener;
   delete m_dcf;
   delete m_rng;
@@ -309,6 +345,20 @@ FullDcaTxop::SetForwardQueue (Ptr<ForwardQueue> forwardQueue)
 {
   m_forwardQueue = forwardQueue;
 }
+void
+FullDcaTxop::SetReturnPacketPolicy (Ptr<FullReturnPacketPolicy> policy)
+{
+  if (policy == 0)
+    {
+      policy = CreateObject<FullFirstReturnPacketPolicy> ();
+    }
+  m_returnPolicy = policy;
+}
+Ptr<FullReturnPacketPolicy>
+FullDcaTxop::GetReturnPacketPolicy (void) const
+{
+  return m_returnPolicy;
+}
 bool
 FullDcaTxop::GetEnableBusyTone (void) const
 {
@@ -595,12 +645,15 @@ FullDcaTxop::NotifyAccessGranted (void)
 }
 
 void
-FullDcaTxop::NotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+FullDcaTxop::NotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
 {
         NS_LOG_FUNCTION (this);
 
-        FullWifiMacHeader receiveHdr;
-        packet->PeekHeader (receiveHdr);
+        if (!frame->HasHeader ())
+          {
+            return;
+          }
+        const FullWifiMacHeader &receiveHdr = frame->GetHeader ();
         NS_LOG_INFO("srouce: " << receiveHdr.GetAddr2 () <<"  dst: " << receiveHdr.GetAddr1 ());
 
 //        if ( receiveHdr.GetAddr2 () == Mac48Address ("00:00:00:00:00:00")) //ack packets
@@ -652,7 +705,8 @@ FullDcaTxop::NotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifi
 //              {
                 //current packet is empty, try to select a packet from the queue
                 //it could be a return packet or a forward packet depends
-                packet = CheckForForwardPacket (&hdr, receiveHdr.GetAddr2 ());
+                Ptr<const Packet> packet = CheckForForwardPacket (&hdr, receiveHdr.GetAddr2 (),
+                                                                  duration - delay);
                 if (packet != 0 && (m_enableForward || m_enableReturnPacket))
                   {
                     m_queue->PushFront (packet, hdr);
@@ -714,14 +768,42 @@ FullDcaTxop::SendBusyTone (Time duration, Mac48Address dst)
 }
 
 Ptr<const Packet>
-FullDcaTxop::CheckForReturnPacket (FullWifiMacHeader *hdr, Mac48Address src)
+FullDcaTxop::CheckForReturnPacket (FullWifiMacHeader *hdr, Mac48Address src, Time remaining)
 {
   NS_LOG_FUNCTION (this);
-  return m_queue->DequeueFirstAvailable (hdr, src);
+  m_queue->PeekByDestination (src, m_returnPolicy->GetMaxCandidates (),
+                              &m_returnCandidates, &m_returnHeaders);
+  if (m_returnCandidates.empty ())
+    {
+      return 0;
+    }
+  m_returnDurations.clear ();
+  for (uint32_t i = 0; i < m_returnCandidates.size (); i++)
+    {
+      m_returnDurations.push_back (m_low->CalculateDataTxDuration (m_returnCandidates[i],
+                                                                   &m_returnHeaders[i]));
+    }
+  uint32_t selected = m_returnPolicy->Select (m_returnDurations, remaining);
+  NS_ASSERT (selected < m_returnCandidates.size ());
+  Ptr<const Packet> packet = m_returnCandidates[selected];
+  *hdr = m_returnHeaders[selected];
+  bool removed = m_queue->RemoveByDestination (src, packet);
+  NS_ASSERT (removed);
+  (void) removed;
+
+  Time duration = m_returnDurations[selected];
+  double overlap = 0;
+  if (remaining > Seconds (0))
+    {
+      overlap = std::min (duration, remaining).GetSeconds () / std::max (duration, remaining).GetSeconds ();
+    }
+  m_returnOverlapTrace (overlap);
+  m_returnCandidates.clear ();
+  return packet;
 }
 
 Ptr<const Packet>
-FullDcaTxop::CheckForForwardPacket (FullWifiMacHeader *hdr, Mac48Address src)
+FullDcaTxop::CheckForForwardPacket (FullWifiMacHeader *hdr, Mac48Address src, Time remaining)
 {
   NS_LOG_FUNCTION (this);
   Ptr<const Packet> packet;
@@ -740,7 +822,7 @@ FullDcaTxop::CheckForForwardPacket (FullWifiMacHeader *hdr, Mac48Address src)
     {
       if ((!m_enableForward || m_forwardQueue->Size () == 0) && m_enableReturnPacket)
         {
-           packet = CheckForReturnPacket (hdr, src);
+           packet = CheckForReturnPacket (hdr, src, remaining);
            if (packet != 0)
            {
         	   hdr->SetType (FULL_WIFI_MAC_RETURN_DATA);
@@ -754,11 +836,11 @@ FullDcaTxop::CheckForForwardPacket (FullWifiMacHeader *hdr, Mac48Address src)
           {
         	  return 0;
           }
-          std::list<ForwardItem> qu = map->GetQueue ();
-          std::list<ForwardItem>::iterator it;
+          const std::vector<ForwardItem> &qu = map->GetQueue ();
+          std::vector<ForwardItem>::const_iterator it;
           for (it = qu.begin (); it != qu.end (); it++)
             {
-              Ptr<const Packet> packet = CheckForReturnPacket (hdr, (*it).add);
+              Ptr<const Packet> packet = CheckForReturnPacket (hdr, (*it).add, remaining);
               if (packet != 0)
                 {
             	  hdr->SetType (FULL_WIFI_MAC_FORWARD_DATA);
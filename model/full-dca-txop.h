@@ -31,9 +31,14 @@
 #include "ns3/full-wifi-remote-station-manager.h"
 #include "ns3/full-dcf.h"
 #include "ns3/full-wifi-preamble.h"
+#include "ns3/full-wifi-rx-frame.h"
+#include "ns3/full-return-packet-policy.h"
 #include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
 
 #include <algorithm>
+#include <vector>
+#include <unordered_map>
 
 
 namespace ns3 {
@@ -72,52 +77,59 @@ struct sort_pred {
   }
 };
 
+//the candidates are kept sorted by priority, so that they can be read
+//in order without sorting or copying them
 class ForwardMap
 {
 public:
   ForwardMap () {};
   ForwardMap (Mac48Address tx)
     : m_primaryTransmitter (tx) {};
-  ForwardMap (Mac48Address tx, std::list<ForwardItem> queue)
-    : m_primaryTransmitter (tx), m_forwardQueue (queue) {};
+  ForwardMap (Mac48Address tx, const std::vector<ForwardItem> &queue)
+    : m_primaryTransmitter (tx), m_forwardQueue (queue) { SortQueue (); };
 
-  void AddItem (ForwardItem newItem) { m_forwardQueue.push_back (newItem); SortQueue ();}
-  void SetQueue (std::list<ForwardItem> queue) { m_forwardQueue = queue; }
+  void AddItem (const ForwardItem &newItem);
+  void SetQueue (const std::vector<ForwardItem> &queue) { m_forwardQueue = queue; SortQueue (); }
   void SortQueue ();
   void SetTransmitterAddress (Mac48Address add) { m_primaryTransmitter = add; }
-  uint32_t Size () { return m_forwardQueue.size (); }
+  uint32_t Size () const { return m_forwardQueue.size (); }
   Mac48Address GetTransmitterAddress (void) const { return m_primaryTransmitter; }
-  std::list<ForwardItem> GetQueue (void) const { return m_forwardQueue; }
+  const std::vector<ForwardItem> & GetQueue (void) const { return m_forwardQueue; }
 
   void RemoveItem (Mac48Address add);
+  // the pointer is invalidated by the next AddItem, RemoveItem or SetQueue
   ForwardItem* GetItem (Mac48Address add) ;
   void UpdateItem (Mac48Address add, double p);
 
 private:
   Mac48Address m_primaryTransmitter;
-  std::list<ForwardItem> m_forwardQueue;
+  std::vector<ForwardItem> m_forwardQueue;
 
 };
 
 
 
-//store the forwarding policies for different transmitter in one list
+//store the forwarding policies for different transmitter, indexed by
+//transmitter address. The maps are looked up on every received data
+//frame and never walked in order, hence the hash table.
 class ForwardQueue :public Object
 {
 public:
+  typedef std::unordered_map<Mac48Address, ForwardMap, FullMac48AddressHash> ForwardMaps;
+
   ForwardQueue () {};
-  ForwardQueue (std::list<ForwardMap> queue)
-    : m_forwardQueue (queue) {};
+  ForwardQueue (const std::vector<ForwardMap> &queue);
 
-  void AddForwardMap (ForwardMap newItem) { m_forwardQueue.push_back (newItem); }
-  std::list<ForwardMap> GetQueue (void) const { return m_forwardQueue; }
-  uint32_t Size () { return m_forwardQueue.size (); }
+  // a map for a transmitter which already has one is ignored
+  void AddForwardMap (const ForwardMap &newItem);
+  const ForwardMaps & GetQueue (void) const { return m_forwardQueue; }
+  uint32_t Size () const { return m_forwardQueue.size (); }
 
   ForwardMap *GetForwardMap (Mac48Address add) ;
 
 private:
   Mac48Address m_primaryTransmitter;
-  std::list<ForwardMap> m_forwardQueue;
+  ForwardMaps m_forwardQueue;
 };
 
 
@@ -188,6 +200,13 @@ public:
   bool GetEnableReturnPacket (void) const;
   bool GetEnableForward (void) const;
   Ptr<ForwardQueue> GetForwardQueue (void) const;
+  /**
+   * \param policy how to choose among the packets queued for the
+   *        secondary receiver; 0 restores the default, which sends the
+   *        first one
+   */
+  void SetReturnPacketPolicy (Ptr<FullReturnPacketPolicy> policy);
+  Ptr<FullReturnPacketPolicy> GetReturnPacketPolicy (void) const;
   void SendBusyTone (Time duration, Mac48Address dst);
 
   /**
@@ -228,7 +247,7 @@ private:
   void NotifyAccessGranted (void);
   void NotifyInternalCollision (void);
   void NotifyCollision (void);
-  void NotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble);
+  void NotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble);
   /**
   * When a channel switching occurs, enqueued packets are removed.
   */
@@ -256,8 +275,16 @@ private:
   Ptr<Packet> GetFragmentPacket (FullWifiMacHeader *hdr);
   virtual void DoDispose (void);
 
-  Ptr<const Packet> CheckForReturnPacket (FullWifiMacHeader *hdr, Mac48Address src);
-  Ptr<const Packet> CheckForForwardPacket (FullWifiMacHeader *hdr, Mac48Address src);
+  /**
+   * \param hdr the header of the packet returned
+   * \param src the destination of the packet
+   * \param remaining the time left until the end of the primary frame
+   *
+   * The duration of each candidate is computed with the mode the station
+   * manager picks for src, as FullMacLow will send it.
+   */
+  Ptr<const Packet> CheckForReturnPacket (FullWifiMacHeader *hdr, Mac48Address src, Time remaining);
+  Ptr<const Packet> CheckForForwardPacket (FullWifiMacHeader *hdr, Mac48Address src, Time remaining);
 
   FullDcf *m_dcf;
   FullDcfManager *m_manager;
@@ -284,6 +311,16 @@ private:
   // the double value is the priority for the address
   Ptr<ForwardQueue> m_forwardQueue;
   EventId m_returnEvent;
+  Ptr<FullReturnPacketPolicy> m_returnPolicy;
+  // the candidates handed to m_returnPolicy, kept to reuse their storage
+  std::vector<Ptr<const Packet> > m_returnCandidates;
+  std::vector<FullWifiMacHeader> m_returnHeaders;
+  std::vector<Time> m_returnDurations;
+  /**
+   * The overlap of the return or forward packet with the rest of the
+   * primary frame: the shorter of the two durations over the longer.
+   */
+  TracedCallback<double> m_returnOverlapTrace;
 
 };
 
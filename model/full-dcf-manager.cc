@@ -226,9 +226,9 @@ public:
   virtual ~FullPhyListener ()
   {
   }
-  virtual void NotifyRxStart (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+  virtual void NotifyRxStart (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
   {
-    m_dcf->NotifyRxStartNow (duration, packet, txMode, preamble);
+    m_dcf->NotifyRxStartNow (duration, frame, txMode, preamble);
   }
   virtual void NotifyRxEndOk (void)
   {
@@ -597,7 +597,7 @@ FullDcfManager::DoRestartAccessTimeoutIfNeeded (void)
 }
 
 void
-FullDcfManager::NotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+FullDcfManager::NotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
 {
   //add the reaction to the incoming packet
   //notify the mac layer abou the new arriving packet
@@ -607,7 +607,7 @@ FullDcfManager::NotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullW
   for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++)
     {
       FullDcfState *state = *i;
-      state->DoNotifyRxStartNow(duration, packet, txMode, preamble);
+      state->DoNotifyRxStartNow(duration, frame, txMode, preamble);
     }
 
   MY_DEBUG ("rx start for=" << duration);
@@ -26,6 +26,7 @@
 #include "ns3/packet.h"
 #include "full-wifi-mode.h"
 #include "full-wifi-preamble.h"
+#include "full-wifi-rx-frame.h"
 #include <vector>
 
 namespace ns3 {
@@ -119,7 +120,7 @@ private:
    * that a new packet is received. This function is for full duplex use.
    * The received packet could be used by the mac layer to take some reaction.
    */
-  virtual void DoNotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble) = 0;
+  virtual void DoNotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble) = 0;
 
 
   /**
@@ -251,7 +252,7 @@ public:
    * Notify the DCF that a packet reception started
    * for the expected duration.
    */
-  void NotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble);
+  void NotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble);
   /**
    * Notify the DCF that a packet reception was just
    * completed successfully.
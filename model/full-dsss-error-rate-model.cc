@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "full-dsss-error-rate-model.h"
 #include <cmath>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE ("FullDsssErrorRateModel");
 
@@ -133,9 +134,36 @@ IntegralFunction (double x, void *params)
   return IntegralFunction;
 }
 
+/**
+ * Integration workspace shared by all the evaluations of equation (18).
+ */
+class FullCckWorkspace
+{
+public:
+  FullCckWorkspace ()
+    : m_workspace (gsl_integration_workspace_alloc (1000))
+  {
+  }
+  ~FullCckWorkspace ()
+  {
+    gsl_integration_workspace_free (m_workspace);
+  }
+  gsl_integration_workspace* Get (void)
+  {
+    return m_workspace;
+  }
+private:
+  gsl_integration_workspace *m_workspace;
+};
+
+static const double CCK_TABLE_MIN_DB = -10.0;
+static const double CCK_TABLE_MAX_DB = 30.0;
+static const double CCK_TABLE_STEP_DB = 0.05;
+
 double
-FullDsssErrorRateModel::SymbolErrorProb16Cck (double e2)
+FullDsssErrorRateModel::IntegrateSymbolErrorProb16Cck (double e2)
 {
+  static FullCckWorkspace workspace;
   double sep;
   double error;
 
@@ -143,14 +171,11 @@ FullDsssErrorRateModel::SymbolErrorProb16Cck (double e2)
   params.beta = std::sqrt (2.0 * e2);
   params.n = 8.0;
 
-  gsl_integration_workspace * w = gsl_integration_workspace_alloc (1000);
-
   gsl_function F;
   F.function = &IntegralFunction;
   F.params = &params;
 
-  gsl_integration_qagiu (&F,-params.beta, 0, 1e-7, 1000, w, &sep, &error);
-  gsl_integration_workspace_free (w);
+  gsl_integration_qagiu (&F,-params.beta, 0, 1e-7, 1000, workspace.Get (), &sep, &error);
   if (error == 0.0)
     {
       sep = 1.0;
@@ -159,6 +184,56 @@ FullDsssErrorRateModel::SymbolErrorProb16Cck (double e2)
   return 1.0 - sep;
 }
 
+bool
+FullDsssErrorRateModel::LookupSymbolErrorProb16Cck (double e2, double *sep)
+{
+  static std::vector<double> table;
+  static const uint32_t size = static_cast<uint32_t> ((CCK_TABLE_MAX_DB - CCK_TABLE_MIN_DB) / CCK_TABLE_STEP_DB + 0.5) + 1;
+  if (e2 <= 0)
+    {
+      return false;
+    }
+  double position = (10.0 * std::log10 (e2) - CCK_TABLE_MIN_DB) / CCK_TABLE_STEP_DB;
+  if (!(position >= 0) || position >= size - 1)
+    {
+      return false;
+    }
+  if (table.empty ())
+    {
+      NS_LOG_DEBUG ("tabulating the CCK symbol error probability over " << size << " points");
+      table.resize (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          double db = CCK_TABLE_MIN_DB + i * CCK_TABLE_STEP_DB;
+          table[i] = IntegrateSymbolErrorProb16Cck (std::pow (10.0, db / 10.0));
+        }
+    }
+  uint32_t i = static_cast<uint32_t> (position);
+  double t = position - i;
+  double low = table[i];
+  double high = table[i + 1];
+  if (low > 0 && high > 0)
+    {
+      *sep = std::exp ((1 - t) * std::log (low) + t * std::log (high));
+    }
+  else
+    {
+      *sep = (1 - t) * low + t * high;
+    }
+  return true;
+}
+
+double
+FullDsssErrorRateModel::SymbolErrorProb16Cck (double e2)
+{
+  double sep;
+  if (LookupSymbolErrorProb16Cck (e2, &sep))
+    {
+      return sep;
+    }
+  return IntegrateSymbolErrorProb16Cck (e2);
+}
+
 double FullDsssErrorRateModel::SymbolErrorProb256Cck (double e1)
 {
   return 1.0 - std::pow (1.0 - SymbolErrorProb16Cck (e1 / 2.0), 2.0);
@@ -59,10 +59,19 @@ double IntegralFunction (double x, void *params);
  *  This model is designed to run with highest accuracy using the Gnu
  *  Scientific Library (GSL), but if GSL is not installed on the platform,
  *  will fall back to (slightly less accurate) Matlab-derived models for
- *  the CCK modulation types.
+ *  the CCK modulation types. The wscript defines FULL_ENABLE_GSL when GSL
+ *  was found at configuration time.
  *
  *  More detailed description and validation can be found in
  *      http://www.nsnam.org/~pei/80211b.pdf
+ *
+ *  With GSL, the CCK symbol error probability of equation (18) is
+ *  integrated once over a grid of 0.05 dB between -10 dB and 30 dB,
+ *  the first time it is needed, and interpolated linearly in the log
+ *  domain afterwards. The interpolated value stays within 1e-5 (absolute)
+ *  of the integral, and within 0.1% (relative) wherever the integral
+ *  exceeds 1e-9. Values outside of the grid are
+ *  integrated directly, reusing a single GSL workspace.
  */
 class FullDsssErrorRateModel
 {
@@ -75,6 +84,15 @@ public:
 #ifdef FULL_ENABLE_GSL
   static double SymbolErrorProb16Cck (double e2);  /// equation (18) in Pursley's paper
   static double SymbolErrorProb256Cck (double e1);  /// equation (17) in Pursley's paper
+private:
+  /// numerical integration of equation (18)
+  static double IntegrateSymbolErrorProb16Cck (double e2);
+  /**
+   * \param e2 the energy per symbol to noise ratio
+   * \param sep set to the interpolated symbol error probability
+   * \return false if e2 is out of the table
+   */
+  static bool LookupSymbolErrorProb16Cck (double e2, double *sep);
 #else
 protected:
   static const double FULL_WLAN_SIR_PERFECT;
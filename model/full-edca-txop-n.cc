@@ -66,7 +66,7 @@ private:
   {
     m_txop->NotifyChannelSwitching ();
   }
-  virtual void DoNotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+  virtual void DoNotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
   {
       //do nothing, this function is used for full duplex transmission
       //currently only nqos module is working
@@ -18,6 +18,13 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "full-error-rate-model.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+
+NS_LOG_COMPONENT_DEFINE ("FullErrorRateModel");
 
 namespace ns3 {
 
@@ -27,10 +34,77 @@ TypeId FullErrorRateModel::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::FullErrorRateModel")
     .SetParent<Object> ()
+    .AddAttribute ("UseTable",
+                   "Interpolate the coded bit error rate of OFDM modes from precomputed tables "
+                   "instead of evaluating the exact formula for every chunk.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FullErrorRateModel::m_useTable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TableMinSnr",
+                   "Lowest snr (dB) covered by the tables.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&FullErrorRateModel::SetTableMinSnr,
+                                       &FullErrorRateModel::GetTableMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("TableMaxSnr",
+                   "Highest snr (dB) covered by the tables.",
+                   DoubleValue (40.0),
+                   MakeDoubleAccessor (&FullErrorRateModel::SetTableMaxSnr,
+                                       &FullErrorRateModel::GetTableMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("TableStep",
+                   "Snr (dB) between two entries of the tables.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&FullErrorRateModel::SetTableStep,
+                                       &FullErrorRateModel::GetTableStep),
+                   MakeDoubleChecker<double> (0.001))
   ;
   return tid;
 }
 
+FullErrorRateModel::FullErrorRateModel ()
+{
+}
+
+void
+FullErrorRateModel::SetTableMinSnr (double snrDb)
+{
+  m_tableMinSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+FullErrorRateModel::GetTableMinSnr (void) const
+{
+  return m_tableMinSnrDb;
+}
+
+void
+FullErrorRateModel::SetTableMaxSnr (double snrDb)
+{
+  m_tableMaxSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+FullErrorRateModel::GetTableMaxSnr (void) const
+{
+  return m_tableMaxSnrDb;
+}
+
+void
+FullErrorRateModel::SetTableStep (double stepDb)
+{
+  m_tableStepDb = stepDb;
+  m_tables.clear ();
+}
+
+double
+FullErrorRateModel::GetTableStep (void) const
+{
+  return m_tableStepDb;
+}
+
 double
 FullErrorRateModel::CalculateSnr (FullWifiMode txMode, double ber) const
 {
@@ -55,4 +129,80 @@ FullErrorRateModel::CalculateSnr (FullWifiMode txMode, double ber) const
   return low;
 }
 
+double
+FullErrorRateModel::DoGetCodedBitErrorRate (FullWifiMode mode, double snr) const
+{
+  return -1.0;
+}
+
+double
+FullErrorRateModel::LookupCodedBitErrorRate (FullWifiMode mode, double snr) const
+{
+  if (snr <= 0)
+    {
+      return -1.0;
+    }
+  double position = (10.0 * std::log10 (snr) - m_tableMinSnrDb) / m_tableStepDb;
+  uint32_t size = static_cast<uint32_t> ((m_tableMaxSnrDb - m_tableMinSnrDb) / m_tableStepDb + 0.5) + 1;
+  if (!(position >= 0) || position >= size - 1)
+    {
+      return -1.0;
+    }
+  Tables::iterator it = m_tables.find (mode.GetUid ());
+  if (it == m_tables.end ())
+    {
+      NS_LOG_DEBUG ("tabulating " << mode << " over " << size << " points");
+      std::vector<double> table (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          double snrDb = m_tableMinSnrDb + i * m_tableStepDb;
+          table[i] = DoGetCodedBitErrorRate (mode, std::pow (10.0, snrDb / 10.0));
+        }
+      it = m_tables.insert (std::make_pair (mode.GetUid (), table)).first;
+    }
+  const std::vector<double> &table = it->second;
+  uint32_t i = static_cast<uint32_t> (position);
+  double t = position - i;
+  double low = table[i];
+  double high = table[i + 1];
+  if (low < 0 || high < 0)
+    {
+      return -1.0;
+    }
+  if (low > 0 && high > 0)
+    {
+      return std::exp ((1 - t) * std::log (low) + t * std::log (high));
+    }
+  return (1 - t) * low + t * high;
+}
+
+double
+FullErrorRateModel::GetCodedChunkSuccessRate (FullWifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useTable)
+    {
+      double pe = LookupCodedBitErrorRate (mode, snr);
+      if (pe >= 0)
+        {
+          if (nbits == 0)
+            {
+              return 1.0;
+            }
+          pe = std::min (pe, 1.0);
+          return std::exp (static_cast<double> (nbits) * std::log1p (-pe));
+        }
+    }
+  double pe = DoGetCodedBitErrorRate (mode, snr);
+  if (pe < 0)
+    {
+      return 0;
+    }
+  if (pe == 0.0)
+    {
+      return 1.0;
+    }
+  pe = std::min (pe, 1.0);
+  return std::pow (1 - pe, static_cast<double> (nbits));
+}
+
 } // namespace ns3
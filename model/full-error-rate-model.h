@@ -21,6 +21,8 @@
 #define FULL_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <map>
+#include <vector>
 #include "full-wifi-mode.h"
 #include "ns3/object.h"
 
@@ -29,12 +31,30 @@ namespace ns3 {
  * \ingroup wifi
  * \brief the interface for Wifi's error models
  *
+ * Models whose coded OFDM modes reduce to a per-bit error probability
+ * pe(snr), with a chunk of nbits bits succeeding with probability
+ * (1 - pe)^nbits, can implement DoGetCodedBitErrorRate and compute their
+ * chunk success rates through GetCodedChunkSuccessRate. When the
+ * UseTable attribute is set, pe is then read from a per-mode table
+ * sampled every TableStep dB between TableMinSnr and TableMaxSnr and
+ * interpolated linearly in the log domain, and the exponentiation is
+ * done as exp (nbits * log1p (-pe)). SNRs outside of the table fall
+ * back to the exact formula.
+ *
+ * With the default 0.05 dB step, the tabulated chunk success rate stays
+ * within 2e-4 (absolute) of the exact value for every OFDM mode of the
+ * NIST and Yans models and for any nbits; the error shrinks
+ * quadratically with the step (6e-6 at 0.01 dB, 6e-4 at 0.1 dB).
+ * Changing TableMinSnr, TableMaxSnr or TableStep discards the tables
+ * built so far.
  */
 class FullErrorRateModel : public Object
 {
 public:
   static TypeId GetTypeId (void);
 
+  FullErrorRateModel ();
+
   /**
    * \param txMode a specific transmission mode
    * \param ber a target ber
@@ -44,6 +64,46 @@ public:
   double CalculateSnr (FullWifiMode txMode, double ber) const;
 
   virtual double GetChunkSuccessRate (FullWifiMode mode, double snr, uint32_t nbits) const = 0;
+
+protected:
+  /**
+   * \param mode a coded OFDM transmission mode
+   * \param snr the snr (linear) of the chunk
+   * \param nbits the number of bits in the chunk
+   * \returns the probability that all the bits of the chunk are received
+   *          correctly, 0 if the model has no coded bit error rate for mode.
+   */
+  double GetCodedChunkSuccessRate (FullWifiMode mode, double snr, uint32_t nbits) const;
+  /**
+   * \param mode a transmission mode
+   * \param snr the snr (linear)
+   * \returns the probability that a decoded bit is in error, not clamped
+   *          to 1, or a negative value if the model has no such
+   *          probability for mode.
+   */
+  virtual double DoGetCodedBitErrorRate (FullWifiMode mode, double snr) const;
+
+private:
+  typedef std::map<uint32_t, std::vector<double> > Tables;
+
+  void SetTableMinSnr (double snrDb);
+  double GetTableMinSnr (void) const;
+  void SetTableMaxSnr (double snrDb);
+  double GetTableMaxSnr (void) const;
+  void SetTableStep (double stepDb);
+  double GetTableStep (void) const;
+
+  /**
+   * \returns the tabulated coded bit error rate, or a negative value if
+   *          snr is out of the table or mode cannot be tabulated.
+   */
+  double LookupCodedBitErrorRate (FullWifiMode mode, double snr) const;
+
+  bool m_useTable;           //!< use the interpolated tables
+  double m_tableMinSnrDb;    //!< snr (dB) of the first entry of the tables
+  double m_tableMaxSnrDb;    //!< snr (dB) of the last entry of the tables
+  double m_tableStepDb;      //!< snr (dB) between two entries of the tables
+  mutable Tables m_tables;   //!< coded bit error rates indexed by mode uid
 };
 
 } // namespace ns3
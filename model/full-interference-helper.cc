@@ -32,6 +32,61 @@ namespace ns3 {
  *       Phy event class
  ****************************************************************/
 
+/**
+ * Free list of event-sized blocks. The simulator runs events on a
+ * single thread, so no locking is needed.
+ */
+class FullEventPool
+{
+public:
+  void* Allocate (std::size_t size)
+  {
+    if (size == sizeof (FullInterferenceHelper::Event) && !m_free.empty ())
+      {
+        void *p = m_free.back ();
+        m_free.pop_back ();
+        return p;
+      }
+    return ::operator new (size);
+  }
+  void Release (void *p, std::size_t size)
+  {
+    if (size == sizeof (FullInterferenceHelper::Event) && m_free.size () < MAX_FREE)
+      {
+        m_free.push_back (p);
+        return;
+      }
+    ::operator delete (p);
+  }
+private:
+  /// upper bound on the number of idle blocks kept around
+  static const std::size_t MAX_FREE = 4096;
+  std::vector<void *> m_free;
+};
+
+/**
+ * The pool is never destroyed: events may still be released by other
+ * static objects torn down at exit, after a function-local pool would
+ * already be gone. The blocks it holds are reclaimed with the process.
+ */
+static FullEventPool &
+GetEventPool (void)
+{
+  static FullEventPool *pool = new FullEventPool;
+  return *pool;
+}
+
+void*
+FullInterferenceHelper::Event::operator new (std::size_t size)
+{
+  return GetEventPool ().Allocate (size);
+}
+void
+FullInterferenceHelper::Event::operator delete (void *p, std::size_t size)
+{
+  GetEventPool ().Release (p, size);
+}
+
 FullInterferenceHelper::Event::Event (uint32_t size, FullWifiMode payloadMode,
                                   enum FullWifiPreamble preamble,
                                   Time duration, double rxPower)
@@ -116,8 +171,12 @@ FullInterferenceHelper::NiChange::operator < (const FullInterferenceHelper::NiCh
 FullInterferenceHelper::FullInterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_backgroundW (0.0),
+    m_backgroundEnergy (0.0),
+    m_rxBackgroundEnergy (0.0)
 {
+  ResetCursor ();
 }
 FullInterferenceHelper::~FullInterferenceHelper ()
 {
@@ -176,10 +235,9 @@ double
 FullInterferenceHelper::GetCurrentEnergyPower (void)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
-  noiseInterferenceW = m_firstPower;
-  NiChanges::iterator nowIterator = GetPosition (now);
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != nowIterator; i++)
+  AdvanceCursor (now);
+  double noiseInterferenceW = m_energyBefore + m_backgroundW;
+  for (NiChanges::const_iterator i = m_cursor; i != m_niChanges.end () && i->GetTime () == now; i++)
     {
       noiseInterferenceW += i->GetDelta ();
     }
@@ -190,17 +248,13 @@ Time
 FullInterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
+  AdvanceCursor (now);
+  double noiseInterferenceW = m_energyBefore + m_backgroundW;
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (NiChanges::const_iterator i = m_cursor; i != m_niChanges.end (); i++)
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
       if (noiseInterferenceW < energyW)
         {
           break;
@@ -221,7 +275,9 @@ FullInterferenceHelper::AppendEvent (Ptr<FullInterferenceHelper::Event> event)
           m_firstPower += i->GetDelta ();
         }
       m_niChanges.erase (m_niChanges.begin (), nowIterator);
+      // every remaining change is later than now
       m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      ResetCursor ();
     }
   else
     {
@@ -231,6 +287,25 @@ FullInterferenceHelper::AppendEvent (Ptr<FullInterferenceHelper::Event> event)
 
 }
 
+void
+FullInterferenceHelper::ResetCursor (void)
+{
+  m_cursor = m_niChanges.begin ();
+  m_cursorTime = m_niChanges.empty () ? Seconds (0) : m_cursor->GetTime ();
+  m_energyBefore = m_firstPower;
+}
+
+void
+FullInterferenceHelper::AdvanceCursor (Time now)
+{
+  NS_ASSERT (now >= m_cursorTime);
+  while (m_cursor != m_niChanges.end () && m_cursor->GetTime () < now)
+    {
+      m_energyBefore += m_cursor->GetDelta ();
+      m_cursor++;
+    }
+  m_cursorTime = now;
+}
 
 double
 FullInterferenceHelper::CalculateSnr (double signal, double noiseInterference, FullWifiMode mode) const
@@ -247,21 +322,10 @@ FullInterferenceHelper::CalculateSnr (double signal, double noiseInterference, F
 }
 
 double
-FullInterferenceHelper::CalculateNoiseInterferenceW (Ptr<FullInterferenceHelper::Event> event, NiChanges *ni) const
+FullInterferenceHelper::CalculateNoiseInterferenceW (Ptr<FullInterferenceHelper::Event> event) const
 {
-  double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
-    {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
-    }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
-  return noiseInterference;
+  return m_firstPower;
 }
 
 double
@@ -278,23 +342,40 @@ FullInterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, F
 }
 
 double
-FullInterferenceHelper::CalculatePer (Ptr<const FullInterferenceHelper::Event> event, NiChanges *ni) const
+FullInterferenceHelper::CalculatePer (Ptr<const FullInterferenceHelper::Event> event, double noiseInterferenceW) const
 {
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  Time previous = event->GetStartTime ();
   FullWifiMode payloadMode = event->GetPayloadMode ();
   FullWifiPreamble preamble = event->GetPreambleType ();
   FullWifiMode headerMode = FullWifiPhy::GetPlcpHeaderMode (payloadMode, preamble);
-  Time plcpHeaderStart = (*j).GetTime () + MicroSeconds (FullWifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble));
+  Time plcpHeaderStart = previous + MicroSeconds (FullWifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble));
   Time plcpPayloadStart = plcpHeaderStart + MicroSeconds (FullWifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble));
-  double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
 
-  j++;
-  while (ni->end () != j)
+  /* The first change is the start of the received event itself: walk the
+   * following ones in place up to the end of the event, which closes the
+   * last chunk.
+   */
+  NiChanges::const_iterator j = ++m_niChanges.begin ();
+  bool last = false;
+  while (!last)
     {
-      Time current = (*j).GetTime ();
+      Time current;
+      double delta;
+      if (j == m_niChanges.end ()
+          || ((event->GetEndTime () == j->GetTime ()) && powerW == -j->GetDelta ()))
+        {
+          current = event->GetEndTime ();
+          delta = 0;
+          last = true;
+        }
+      else
+        {
+          current = j->GetTime ();
+          delta = j->GetDelta ();
+          j++;
+        }
       NS_ASSERT (current >= previous);
 
       if (previous >= plcpPayloadStart)
@@ -355,9 +436,8 @@ FullInterferenceHelper::CalculatePer (Ptr<const FullInterferenceHelper::Event> e
             }
         }
 
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
-      j++;
+      noiseInterferenceW += delta;
+      previous = current;
     }
 
   double per = 1 - psr;
@@ -368,8 +448,7 @@ FullInterferenceHelper::CalculatePer (Ptr<const FullInterferenceHelper::Event> e
 struct FullInterferenceHelper::SnrPer
 FullInterferenceHelper::CalculateSnrPer (Ptr<FullInterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event) + GetMeanBackgroundPower (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
@@ -377,7 +456,7 @@ FullInterferenceHelper::CalculateSnrPer (Ptr<FullInterferenceHelper::Event> even
   /* calculate the SNIR at the start of the packet and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePer (event, &ni);
+  double per = CalculatePer (event, noiseInterferenceW);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -391,22 +470,61 @@ FullInterferenceHelper::EraseEvents (void)
   m_niChanges.clear ();
   m_rxing = false;
   m_firstPower = 0.0;
+  ResetCursor ();
 }
 FullInterferenceHelper::NiChanges::iterator
 FullInterferenceHelper::GetPosition (Time moment)
 {
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
-
+  return m_niChanges.upper_bound (NiChange (moment, 0));
 }
 void
 FullInterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  // a multiset inserts after the changes with an equal time, so that
+  // simultaneous changes keep their arrival order
+  NiChanges::iterator i = m_niChanges.insert (change);
+  if (change.GetTime () < m_cursorTime)
+    {
+      m_energyBefore += change.GetDelta ();
+    }
+  else if (m_cursor == m_niChanges.end () || i->GetTime () < m_cursor->GetTime ())
+    {
+      m_cursor = i;
+    }
 }
 void
 FullInterferenceHelper::NotifyRxStart ()
 {
   m_rxing = true;
+  m_rxBackgroundEnergy = GetBackgroundEnergy (Simulator::Now ());
+}
+void
+FullInterferenceHelper::SetBackgroundPower (double powerW)
+{
+  Time now = Simulator::Now ();
+  m_backgroundEnergy = GetBackgroundEnergy (now);
+  m_backgroundChange = now;
+  m_backgroundW = powerW;
+}
+double
+FullInterferenceHelper::GetBackgroundEnergy (Time now) const
+{
+  return m_backgroundEnergy + m_backgroundW * (now - m_backgroundChange).GetSeconds ();
+}
+double
+FullInterferenceHelper::GetMeanBackgroundPower (Ptr<const Event> event) const
+{
+  if (m_backgroundW == 0.0 && m_backgroundEnergy == 0.0)
+    {
+      return 0.0;
+    }
+  Time now = Simulator::Now ();
+  Time duration = now - event->GetStartTime ();
+  if (duration.IsZero ())
+    {
+      return m_backgroundW;
+    }
+  return (GetBackgroundEnergy (now) - m_rxBackgroundEnergy) / duration.GetSeconds ();
 }
 void
 FullInterferenceHelper::NotifyRxEnd ()
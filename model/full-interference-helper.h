@@ -21,8 +21,10 @@
 #define FULL_INTERFERENCE_HELPER_H
 
 #include <stdint.h>
+#include <cstddef>
 #include <vector>
 #include <list>
+#include <set>
 #include "full-wifi-mode.h"
 #include "full-wifi-preamble.h"
 #include "full-wifi-phy-standard.h"
@@ -55,6 +57,14 @@ public:
     uint32_t GetSize (void) const;
     FullWifiMode GetPayloadMode (void) const;
     enum FullWifiPreamble GetPreambleType (void) const;
+
+    /**
+     * Events are allocated for every incoming signal, including the ones
+     * dropped right away, so their storage is recycled through a free
+     * list instead of going back to the heap.
+     */
+    static void* operator new (std::size_t size);
+    static void operator delete (void *p, std::size_t size);
 private:
     uint32_t m_size;
     FullWifiMode m_payloadMode;
@@ -98,6 +108,15 @@ private:
   void NotifyRxStart ();
   void NotifyRxEnd ();
   void EraseEvents (void);
+  /**
+   * \param powerW the aggregate power (W) of the far-field interferers
+   *        currently heard, which are not tracked as individual events
+   *
+   * The background power adds to the energy seen by the CCA queries. The
+   * SNIR of a received packet accounts for its mean value over the
+   * reception.
+   */
+  void SetBackgroundPower (double powerW);
 private:
   class NiChange
   {
@@ -110,16 +129,32 @@ private:
     Time m_time;
     double m_delta;
   };
-  typedef std::vector <NiChange> NiChanges;
+  /**
+   * Changes are kept sorted by time; changes with equal times keep
+   * their insertion order.
+   */
+  typedef std::multiset <NiChange> NiChanges;
   typedef std::list<Ptr<Event> > Events;
 
   FullInterferenceHelper (const FullInterferenceHelper &o);
   FullInterferenceHelper &operator = (const FullInterferenceHelper &o);
   void AppendEvent (Ptr<Event> event);
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  /**
+   * \param event the event being received
+   * \return the noise and interference power (W) at the start of the event
+   */
+  double CalculateNoiseInterferenceW (Ptr<Event> event) const;
   double CalculateSnr (double signal, double noiseInterference, FullWifiMode mode) const;
   double CalculateChunkSuccessRate (double snir, Time delay, FullWifiMode mode) const;
-  double CalculatePer (Ptr<const Event> event, NiChanges *ni) const;
+  /**
+   * \param event the event being received
+   * \param noiseInterferenceW the noise and interference power (W) at the start of the event
+   * \return the packet error rate of the event
+   *
+   * Walks m_niChanges in place, accumulating the success rate of each
+   * chunk of the event with a constant SNIR.
+   */
+  double CalculatePer (Ptr<const Event> event, double noiseInterferenceW) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<FullErrorRateModel> m_errorRateModel;
@@ -130,6 +165,32 @@ private:
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
   void AddNiChangeEvent (NiChange change);
+  /**
+   * \param now the current time
+   *
+   * Move the cursor to the first change not earlier than now, folding
+   * the changes it moves past into m_energyBefore.
+   */
+  void AdvanceCursor (Time now);
+  /// Reset the cursor to the first change, m_firstPower being the energy before it
+  void ResetCursor (void);
+
+  /// first change not earlier than m_cursorTime
+  NiChanges::iterator m_cursor;
+  /// time the cursor was last moved to
+  Time m_cursorTime;
+  /// m_firstPower plus the deltas of all the changes before m_cursor
+  double m_energyBefore;
+
+  /// \return the integral (J) of the background power up to now
+  double GetBackgroundEnergy (Time now) const;
+  /// \return the mean background power (W) since the start of the reception
+  double GetMeanBackgroundPower (Ptr<const Event> event) const;
+
+  double m_backgroundW;             //!< current background power
+  Time m_backgroundChange;          //!< time of the last background change
+  double m_backgroundEnergy;        //!< background energy up to m_backgroundChange
+  double m_rxBackgroundEnergy;      //!< background energy at the start of the reception
 };
 
 } // namespace ns3
@@ -309,6 +309,123 @@ std::ostream &operator << (std::ostream &os, const FullMacLowTransmissionParamet
   return os;
 }
 
+FullMacLowTimers::FullMacLowTimers ()
+  : m_wakeup (),
+    m_wakeupTime (Seconds (0))
+{
+}
+
+uint32_t
+FullMacLowTimers::Add (Handler handler)
+{
+  Timer timer;
+  timer.handler = handler;
+  timer.deadline = Seconds (0);
+  timer.running = false;
+  m_timers.push_back (timer);
+  return m_timers.size () - 1;
+}
+
+void
+FullMacLowTimers::Schedule (uint32_t timer, Time delay)
+{
+  NS_ASSERT (timer < m_timers.size ());
+  m_timers[timer].deadline = Simulator::Now () + delay;
+  m_timers[timer].running = true;
+  ScheduleWakeup ();
+}
+
+void
+FullMacLowTimers::Cancel (uint32_t timer)
+{
+  NS_ASSERT (timer < m_timers.size ());
+  m_timers[timer].running = false;
+  for (std::vector<Timer>::const_iterator i = m_timers.begin (); i != m_timers.end (); i++)
+    {
+      if (i->running)
+        {
+          // a wakeup which is too early is harmless
+          return;
+        }
+    }
+  m_wakeup.Cancel ();
+}
+
+void
+FullMacLowTimers::CancelAll (void)
+{
+  for (std::vector<Timer>::iterator i = m_timers.begin (); i != m_timers.end (); i++)
+    {
+      i->running = false;
+    }
+  m_wakeup.Cancel ();
+}
+
+bool
+FullMacLowTimers::IsRunning (uint32_t timer) const
+{
+  NS_ASSERT (timer < m_timers.size ());
+  return m_timers[timer].running;
+}
+
+bool
+FullMacLowTimers::IsExpired (uint32_t timer) const
+{
+  return !IsRunning (timer);
+}
+
+void
+FullMacLowTimers::ScheduleWakeup (void)
+{
+  bool any = false;
+  Time earliest;
+  for (std::vector<Timer>::const_iterator i = m_timers.begin (); i != m_timers.end (); i++)
+    {
+      if (i->running && (!any || i->deadline < earliest))
+        {
+          earliest = i->deadline;
+          any = true;
+        }
+    }
+  if (!any)
+    {
+      m_wakeup.Cancel ();
+      return;
+    }
+  if (m_wakeup.IsRunning () && m_wakeupTime <= earliest)
+    {
+      // the pending wakeup will reschedule itself for the earliest deadline
+      return;
+    }
+  m_wakeup.Cancel ();
+  m_wakeupTime = earliest;
+  m_wakeup = Simulator::Schedule (earliest - Simulator::Now (), &FullMacLowTimers::Wakeup, this);
+}
+
+void
+FullMacLowTimers::Wakeup (void)
+{
+  Time now = Simulator::Now ();
+  // a handler may start or cancel timers, so look for the next expired
+  // timer again after each of them
+  bool found = true;
+  while (found)
+    {
+      found = false;
+      for (std::vector<Timer>::iterator i = m_timers.begin (); i != m_timers.end (); i++)
+        {
+          if (i->running && i->deadline <= now)
+            {
+              i->running = false;
+              i->handler ();
+              found = true;
+              break;
+            }
+        }
+    }
+  ScheduleWakeup ();
+}
+
 
 /***************************************************************
  *         Listener for PHY events. Forwards to MacLow
@@ -325,8 +442,9 @@ public:
   virtual ~PhyMacLowListener ()
   {
   }
-  virtual void NotifyRxStart (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+  virtual void NotifyRxStart (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
   {
+    m_macLow->NotifyRxStartNow (frame);
   }
   virtual void NotifyRxEndOk (void)
   {
@@ -350,10 +468,7 @@ private:
 
 
 FullMacLow::FullMacLow ()
-  : m_normalAckTimeoutEvent (),
-    m_fastAckTimeoutEvent (),
-    m_superFastAckTimeoutEvent (),
-    m_fastAckFailedTimeoutEvent (),
+  : m_fastAckFailedTimeoutEvent (),
     m_blockAckTimeoutEvent (),
     m_ctsTimeoutEvent (),
     m_sendCtsEvent (),
@@ -368,6 +483,9 @@ FullMacLow::FullMacLow ()
   m_lastNavDuration = Seconds (0);
   m_lastNavStart = Seconds (0);
   m_promisc = false;
+  m_normalAckTimeout = m_timers.Add (MakeCallback (&FullMacLow::NormalAckTimeout, this));
+  m_fastAckTimeout = m_timers.Add (MakeCallback (&FullMacLow::FastAckTimeout, this));
+  m_superFastAckTimeout = m_timers.Add (MakeCallback (&FullMacLow::SuperFastAckTimeout, this));
 }
 
 FullMacLow::~FullMacLow ()
@@ -387,9 +505,7 @@ void
 FullMacLow::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
-  m_normalAckTimeoutEvent.Cancel ();
-  m_fastAckTimeoutEvent.Cancel ();
-  m_superFastAckTimeoutEvent.Cancel ();
+  m_timers.CancelAll ();
   m_fastAckFailedTimeoutEvent.Cancel ();
   m_blockAckTimeoutEvent.Cancel ();
   m_ctsTimeoutEvent.Cancel ();
@@ -400,6 +516,7 @@ FullMacLow::DoDispose (void)
   m_endTxNoAckEvent.Cancel ();
   m_phy = 0;
   m_stationManager = 0;
+  m_rxFrame = 0;
   delete m_phyMacLowListener;
   m_phyMacLowListener = 0;
 }
@@ -409,19 +526,11 @@ FullMacLow::CancelAllEvents (void)
 {
   NS_LOG_FUNCTION (this);
   bool oneRunning = false;
-  if (m_normalAckTimeoutEvent.IsRunning ())
+  if (m_timers.IsRunning (m_normalAckTimeout)
+      || m_timers.IsRunning (m_fastAckTimeout)
+      || m_timers.IsRunning (m_superFastAckTimeout))
     {
-      m_normalAckTimeoutEvent.Cancel ();
-      oneRunning = true;
-    }
-  if (m_fastAckTimeoutEvent.IsRunning ())
-    {
-      m_fastAckTimeoutEvent.Cancel ();
-      oneRunning = true;
-    }
-  if (m_superFastAckTimeoutEvent.IsRunning ())
-    {
-      m_superFastAckTimeoutEvent.Cancel ();
+      m_timers.CancelAll ();
       oneRunning = true;
     }
   if (m_fastAckFailedTimeoutEvent.IsRunning ())
@@ -591,9 +700,9 @@ FullMacLow::GetBssid (void) const
 bool
 FullMacLow::IsWaitingAckTimeout (void) const
 {
-	if (m_normalAckTimeoutEvent.IsRunning ()
-	               || m_fastAckTimeoutEvent.IsRunning ()
-	               || m_superFastAckTimeoutEvent.IsRunning ())
+	if (m_timers.IsRunning (m_normalAckTimeout)
+	               || m_timers.IsRunning (m_fastAckTimeout)
+	               || m_timers.IsRunning (m_superFastAckTimeout))
 	{
 		return true;
 	}
@@ -612,24 +721,19 @@ FullMacLow::UpdateDuplexEnd (Time end)
       Time txDuration = end - Simulator::Now ();
       m_duplexEnd = end;
 
-      //reset the ack timeout events if there is any
-      if (m_normalAckTimeoutEvent.IsRunning ())
+      //move the ack timeouts if there is any: the timers adjust their
+      //deadline in place instead of rescheduling an event
+      if (m_timers.IsRunning (m_normalAckTimeout))
         {
-          Time timerDelay = txDuration + GetAckTimeout ();
-          m_normalAckTimeoutEvent.Cancel ();
-          m_normalAckTimeoutEvent = Simulator::Schedule (timerDelay, &FullMacLow::NormalAckTimeout, this);
+          m_timers.Schedule (m_normalAckTimeout, txDuration + GetAckTimeout ());
         }
-      if (m_fastAckTimeoutEvent.IsRunning ())
+      if (m_timers.IsRunning (m_fastAckTimeout))
         {
-          Time timerDelay = txDuration + GetPifs ();
-          m_fastAckTimeoutEvent.Cancel ();
-          m_fastAckTimeoutEvent = Simulator::Schedule (timerDelay, &FullMacLow::FastAckTimeout, this);
+          m_timers.Schedule (m_fastAckTimeout, txDuration + GetPifs ());
         }
-      if (m_superFastAckTimeoutEvent.IsRunning ())
+      if (m_timers.IsRunning (m_superFastAckTimeout))
         {
-          Time timerDelay = txDuration + GetPifs ();
-          m_superFastAckTimeoutEvent.Cancel ();
-          m_superFastAckTimeoutEvent = Simulator::Schedule (timerDelay, &FullMacLow::SuperFastAckTimeout, this);
+          m_timers.Schedule (m_superFastAckTimeout, txDuration + GetPifs ());
         }
     }
   NS_LOG_FUNCTION("Set duplexEnd to " << m_duplexEnd.GetSeconds ());
@@ -674,7 +778,7 @@ FullMacLow::StartTransmission (Ptr<const Packet> packet,
    * QapScheduler has taken access to the channel from
    * one of the Edca of the QAP.
    */
-  m_currentPacket = packet->Copy ();
+  m_currentPacket = packet;
   m_currentHdr = *hdr;
   CancelAllEvents ();
   m_listener = listener;
@@ -728,6 +832,12 @@ FullMacLow::NotifySwitchingStartNow (Time duration)
   m_listener = 0;
 }
 
+void
+FullMacLow::NotifyRxStartNow (Ptr<const FullWifiRxFrame> frame)
+{
+  m_rxFrame = frame;
+}
+
 void
 FullMacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, FullWifiMode txMode, FullWifiPreamble preamble)
 {
@@ -738,7 +848,20 @@ FullMacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, FullWifiMode txMode, Fu
    * packet queue.
    */
   FullWifiMacHeader hdr;
-  packet->RemoveHeader (hdr);
+  if (m_rxFrame != 0 && m_rxFrame->HasHeader ()
+      && m_rxFrame->GetPacket ()->GetUid () == packet->GetUid ())
+    {
+      // reuse the header the PHY parsed when the reception started
+      hdr = m_rxFrame->GetHeader ();
+      packet->RemoveAtStart (hdr.GetSerializedSize ());
+    }
+  else
+    {
+      // control frames carry their header in the packet metadata whenever
+      // it is enabled, see FullCtrlFrameFactory
+      packet->RemoveHeader (hdr);
+    }
+  m_rxFrame = 0;
 
   // the send ack event should be delay by this much
   Time delay = m_duplexEnd > Simulator::Now () ? m_duplexEnd - Simulator::Now ():Seconds (0);
@@ -798,9 +921,9 @@ FullMacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, FullWifiMode txMode, Fu
     }
   else if (hdr.IsAck ()
            && hdr.GetAddr1 () == m_self
-           && (m_normalAckTimeoutEvent.IsRunning ()
-               || m_fastAckTimeoutEvent.IsRunning ()
-               || m_superFastAckTimeoutEvent.IsRunning ())
+           && (m_timers.IsRunning (m_normalAckTimeout)
+               || m_timers.IsRunning (m_fastAckTimeout)
+               || m_timers.IsRunning (m_superFastAckTimeout))
            && m_txParams.MustWaitAck ())
     {
       NS_LOG_DEBUG ("receive ack from=" << m_currentHdr.GetAddr1 ());
@@ -812,16 +935,16 @@ FullMacLow::ReceiveOk (Ptr<Packet> packet, double rxSnr, FullWifiMode txMode, Fu
                                       rxSnr, txMode, tag.Get ());
       bool gotAck = false;
       if (m_txParams.MustWaitNormalAck ()
-          && m_normalAckTimeoutEvent.IsRunning ())
+          && m_timers.IsRunning (m_normalAckTimeout))
         {
-          m_normalAckTimeoutEvent.Cancel ();
+          m_timers.Cancel (m_normalAckTimeout);
           NotifyAckTimeoutResetNow ();
           gotAck = true;
         }
       if (m_txParams.MustWaitFastAck ()
-          && m_fastAckTimeoutEvent.IsRunning ())
+          && m_timers.IsRunning (m_fastAckTimeout))
         {
-          m_fastAckTimeoutEvent.Cancel ();
+          m_timers.Cancel (m_fastAckTimeout);
           NotifyAckTimeoutResetNow ();
           gotAck = true;
         }
@@ -1134,6 +1257,12 @@ FullMacLow::CalculateTransmissionTime (Ptr<const Packet> packet,
   return txTime;
 }
 
+Time
+FullMacLow::CalculateDataTxDuration (Ptr<const Packet> packet, const FullWifiMacHeader *hdr) const
+{
+  return m_phy->CalculateTxDuration (GetSize (packet, hdr), GetDataTxMode (packet, hdr), FULL_WIFI_PREAMBLE_LONG);
+}
+
 void
 FullMacLow::NotifyNav (const FullWifiMacHeader &hdr, FullWifiMode txMode, FullWifiPreamble preamble)
 {
@@ -1255,7 +1384,7 @@ FullMacLow::ForwardDown (Ptr<const Packet> packet, const FullWifiMacHeader* hdr,
                 ", mode=" << txMode <<
                 ", duration=" << hdr->GetDuration () <<
                 ", seq=0x" << std::hex << m_currentHdr.GetSequenceControl () << std::dec);
-  m_phy->SendPacket (packet, txMode, FULL_WIFI_PREAMBLE_LONG, 22);
+  m_phy->SendPacket (packet, txMode, FULL_WIFI_PREAMBLE_LONG, 22, FullWifiTxMetadata (*hdr));
 
   //FIXME: should only update on sending a data packet
   //move this to send data and dataaftercts
@@ -1345,12 +1474,7 @@ FullMacLow::SendRtsForPacket (void)
 {
   NS_LOG_FUNCTION (this);
   /* send an RTS for this packet. */
-  FullWifiMacHeader rts;
-  rts.SetType (FULL_WIFI_MAC_CTL_RTS);
-  rts.SetDsNotFrom ();
-  rts.SetDsNotTo ();
-  rts.SetNoRetry ();
-  rts.SetNoMoreFragments ();
+  FullWifiMacHeader rts = m_ctrlFrames.GetHeader (FULL_WIFI_MAC_CTL_RTS);
   rts.SetAddr1 (m_currentHdr.GetAddr1 ());
   rts.SetAddr2 (m_self);
   FullWifiMode rtsTxMode = GetRtsTxMode (m_currentPacket, &m_currentHdr);
@@ -1379,10 +1503,7 @@ FullMacLow::SendRtsForPacket (void)
   NotifyCtsTimeoutStartNow (timerDelay);
   m_ctsTimeoutEvent = Simulator::Schedule (timerDelay, &FullMacLow::CtsTimeout, this);
 
-  Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (rts);
-  FullWifiMacTrailer fcs;
-  packet->AddTrailer (fcs);
+  Ptr<Packet> packet = m_ctrlFrames.Create (rts);
 
   ForwardDown (packet, &rts, rtsTxMode);
 }
@@ -1395,24 +1516,23 @@ FullMacLow::StartDataTxTimers (void)
   if (m_txParams.MustWaitNormalAck ())
     {
       Time timerDelay = txDuration + GetAckTimeout ();
-      NS_ASSERT (m_normalAckTimeoutEvent.IsExpired ());
+      NS_ASSERT (m_timers.IsExpired (m_normalAckTimeout));
       NotifyAckTimeoutStartNow (timerDelay);
-      m_normalAckTimeoutEvent = Simulator::Schedule (timerDelay, &FullMacLow::NormalAckTimeout, this);
+      m_timers.Schedule (m_normalAckTimeout, timerDelay);
     }
   else if (m_txParams.MustWaitFastAck ())
     {
       Time timerDelay = txDuration + GetPifs ();
-      NS_ASSERT (m_fastAckTimeoutEvent.IsExpired ());
+      NS_ASSERT (m_timers.IsExpired (m_fastAckTimeout));
       NotifyAckTimeoutStartNow (timerDelay);
-      m_fastAckTimeoutEvent = Simulator::Schedule (timerDelay, &FullMacLow::FastAckTimeout, this);
+      m_timers.Schedule (m_fastAckTimeout, timerDelay);
     }
   else if (m_txParams.MustWaitSuperFastAck ())
     {
       Time timerDelay = txDuration + GetPifs ();
-      NS_ASSERT (m_superFastAckTimeoutEvent.IsExpired ());
+      NS_ASSERT (m_timers.IsExpired (m_superFastAckTimeout));
       NotifyAckTimeoutStartNow (timerDelay);
-      m_superFastAckTimeoutEvent = Simulator::Schedule (timerDelay,
-                                                        &FullMacLow::SuperFastAckTimeout, this);
+      m_timers.Schedule (m_superFastAckTimeout, timerDelay);
     }
   else if (m_txParams.MustWaitBasicBlockAck ())
     {
@@ -1443,6 +1563,21 @@ FullMacLow::StartDataTxTimers (void)
     }
 }
 
+Ptr<Packet>
+FullMacLow::BuildDataFrame (void) const
+{
+  /* The payload is shared with the caller, which keeps it for
+   * retransmissions: Copy only takes a reference on its buffer and
+   * metadata, and the header is written into the free space in front
+   * of the payload rather than into a duplicate of it.
+   */
+  Ptr<Packet> frame = m_currentPacket->Copy ();
+  frame->AddHeader (m_currentHdr);
+  FullWifiMacTrailer fcs;
+  frame->AddTrailer (fcs);
+  return frame;
+}
+
 void
 FullMacLow::SendDataPacket (void)
 {
@@ -1485,19 +1620,22 @@ FullMacLow::SendDataPacket (void)
             }
         }
     }
-  if (m_currentHdr.GetType () != FULL_WIFI_MAC_BUSY_TONE)
+  Ptr<Packet> frame;
+  if (m_currentHdr.GetType () == FULL_WIFI_MAC_BUSY_TONE)
+    {
+      NS_ASSERT (m_currentPacket->GetSize () == 0);
+      frame = m_ctrlFrames.Create (m_currentHdr);
+    }
+  else
     {
       m_currentHdr.SetDuration (duration);
+      frame = BuildDataFrame ();
     }
 
-  m_currentPacket->AddHeader (m_currentHdr);
-  FullWifiMacTrailer fcs;
-  m_currentPacket->AddTrailer (fcs);
-
-  ForwardDown (m_currentPacket, &m_currentHdr, dataTxMode);
+  ForwardDown (frame, &m_currentHdr, dataTxMode);
 
   UpdateDuplexEnd (Simulator::Now () +
-      m_phy->CalculateTxDuration (m_currentPacket->GetSize (), dataTxMode, FULL_WIFI_PREAMBLE_LONG));
+      m_phy->CalculateTxDuration (frame->GetSize (), dataTxMode, FULL_WIFI_PREAMBLE_LONG));
 //  Time duration =
 //      m_phy->CalculateTxDuration (m_currentPacket->GetSize (), dataTxMode, FULL_WIFI_PREAMBLE_LONG);
 
@@ -1526,22 +1664,14 @@ FullMacLow::SendCtsAfterRts (Mac48Address source, Time duration, FullWifiMode rt
    * right after SIFS.
    */
   FullWifiMode ctsTxMode = GetCtsTxModeForRts (source, rtsTxMode);
-  FullWifiMacHeader cts;
-  cts.SetType (FULL_WIFI_MAC_CTL_CTS);
-  cts.SetDsNotFrom ();
-  cts.SetDsNotTo ();
-  cts.SetNoMoreFragments ();
-  cts.SetNoRetry ();
+  FullWifiMacHeader cts = m_ctrlFrames.GetHeader (FULL_WIFI_MAC_CTL_CTS);
   cts.SetAddr1 (source);
   duration -= GetCtsDuration (source, rtsTxMode);
   duration -= GetSifs ();
   NS_ASSERT (duration >= MicroSeconds (0));
   cts.SetDuration (duration);
 
-  Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (cts);
-  FullWifiMacTrailer fcs;
-  packet->AddTrailer (fcs);
+  Ptr<Packet> packet = m_ctrlFrames.Create (cts);
 
   FullSnrTag tag;
   tag.Set (rtsSnr);
@@ -1573,16 +1703,14 @@ FullMacLow::SendDataAfterCts (Mac48Address source, Time duration, FullWifiMode t
   NS_ASSERT (duration >= MicroSeconds (0));
   m_currentHdr.SetDuration (duration);
 
-  m_currentPacket->AddHeader (m_currentHdr);
-  FullWifiMacTrailer fcs;
-  m_currentPacket->AddTrailer (fcs);
+  Ptr<Packet> frame = BuildDataFrame ();
 
   UpdateDuplexEnd (Simulator::Now () +
-      m_phy->CalculateTxDuration (m_currentPacket->GetSize (), dataTxMode, FULL_WIFI_PREAMBLE_LONG));
+      m_phy->CalculateTxDuration (frame->GetSize (), dataTxMode, FULL_WIFI_PREAMBLE_LONG));
 //  Time duration =
 //      m_phy->CalculateTxDuration (m_currentPacket->GetSize (), dataTxMode, FULL_WIFI_PREAMBLE_LONG);
 
-  ForwardDown (m_currentPacket, &m_currentHdr, dataTxMode);
+  ForwardDown (frame, &m_currentHdr, dataTxMode);
   m_currentPacket = 0;
 }
 
@@ -1618,22 +1746,14 @@ FullMacLow::SendAckAfterData (Mac48Address source, Time duration, FullWifiMode d
    * a packet after SIFS.
    */
   FullWifiMode ackTxMode = GetAckTxModeForData (source, dataTxMode);
-  FullWifiMacHeader ack;
-  ack.SetType (FULL_WIFI_MAC_CTL_ACK);
-  ack.SetDsNotFrom ();
-  ack.SetDsNotTo ();
-  ack.SetNoRetry ();
-  ack.SetNoMoreFragments ();
+  FullWifiMacHeader ack = m_ctrlFrames.GetHeader (FULL_WIFI_MAC_CTL_ACK);
   ack.SetAddr1 (source);
   duration -= GetAckDuration (source, dataTxMode);
   duration -= GetSifs ();
   NS_ASSERT (duration >= MicroSeconds (0));
   ack.SetDuration (duration);
 
-  Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (ack);
-  FullWifiMacTrailer fcs;
-  packet->AddTrailer (fcs);
+  Ptr<Packet> packet = m_ctrlFrames.Create (ack);
 
   FullSnrTag tag;
   tag.Set (dataSnr);
@@ -30,6 +30,8 @@
 #include "full-wifi-mac-header.h"
 #include "full-wifi-mode.h"
 #include "full-wifi-preamble.h"
+#include "full-wifi-rx-frame.h"
+#include "full-ctrl-frame-factory.h"
 #include "full-wifi-remote-station-manager.h"
 #include "full-ctrl-headers.h"
 #include "full-mgt-headers.h"
@@ -371,6 +373,79 @@ private:
 
 std::ostream &operator << (std::ostream &os, const FullMacLowTransmissionParameters &params);
 
+/**
+ * \brief timeouts of a FullMacLow sharing a single scheduled event.
+ *
+ * Each timer has a deadline but only the earliest deadline is scheduled
+ * in the simulator. Moving a deadline later, as
+ * FullMacLow::UpdateDuplexEnd does each time a full-duplex reception
+ * extends the exchange, does not touch the event queue: the pending
+ * wakeup finds nothing expired and schedules itself once for the new
+ * earliest deadline.
+ *
+ * Since the wakeup of a moved deadline is only scheduled when the old
+ * deadline is reached, the timeout runs after the events which were
+ * scheduled in between for the same time. Cancelling and rescheduling an
+ * EventId when the deadline is moved would run it before them.
+ */
+class FullMacLowTimers
+{
+public:
+  typedef Callback<void> Handler;
+
+  FullMacLowTimers ();
+
+  /**
+   * \param handler the function to invoke when the timer expires
+   * \return the id of the new timer
+   */
+  uint32_t Add (Handler handler);
+  /**
+   * \param timer the id of a timer
+   * \param delay the delay after which the timer expires
+   *
+   * Start the timer, or move its deadline if it is already running.
+   */
+  void Schedule (uint32_t timer, Time delay);
+  /**
+   * \param timer the id of a timer
+   */
+  void Cancel (uint32_t timer);
+  /**
+   * Stop all the timers.
+   */
+  void CancelAll (void);
+  /**
+   * \param timer the id of a timer
+   * \return true if the timer is running
+   */
+  bool IsRunning (uint32_t timer) const;
+  /**
+   * \param timer the id of a timer
+   * \return true if the timer is not running
+   */
+  bool IsExpired (uint32_t timer) const;
+
+private:
+  struct Timer
+  {
+    Handler handler;
+    Time deadline;
+    bool running;
+  };
+
+  void Wakeup (void);
+  /**
+   * Make sure the wakeup is scheduled no later than the earliest
+   * running deadline.
+   */
+  void ScheduleWakeup (void);
+
+  std::vector<Timer> m_timers;
+  EventId m_wakeup;     //!< the single event scheduled for all the timers
+  Time m_wakeupTime;    //!< the time of m_wakeup
+};
+
 
 /**
  * \ingroup wifi
@@ -437,6 +512,14 @@ public:
   Time CalculateTransmissionTime (Ptr<const Packet> packet,
                                   const FullWifiMacHeader* hdr,
                                   const FullMacLowTransmissionParameters& parameters) const;
+  /**
+   * \param packet packet to send
+   * \param hdr 802.11 header for packet to send
+   * \return the duration of the data frame alone, in the mode the station
+   *         manager picks for its receiver and with the preamble it is
+   *         sent with.
+   */
+  Time CalculateDataTxDuration (Ptr<const Packet> packet, const FullWifiMacHeader *hdr) const;
 
   /**
    * \param packet packet to send
@@ -478,6 +561,13 @@ public:
    * occurs, pending MAC transmissions (RTS, CTS, DATA and ACK) are cancelled.
    */
   void NotifySwitchingStartNow (Time duration);
+  /**
+   * \param frame the frame the PHY started to receive
+   *
+   * Invoked by the PhyMacLowListener. ReceiveOk takes the MAC header of
+   * the frame from here instead of deserializing it again.
+   */
+  void NotifyRxStartNow (Ptr<const FullWifiRxFrame> frame);
   /**
    * \param respHdr Add block ack response from originator (action
    * frame).
@@ -523,6 +613,10 @@ private:
   Time NowUs (void) const;
   void ForwardDown (Ptr<const Packet> packet, const FullWifiMacHeader *hdr,
                     FullWifiMode txMode);
+  /**
+   * \return the on-air frame for m_currentPacket and m_currentHdr
+   */
+  Ptr<Packet> BuildDataFrame (void) const;
   Time CalculateOverallTxTime (Ptr<const Packet> packet,
                                const FullWifiMacHeader* hdr,
                                const FullMacLowTransmissionParameters &params) const;
@@ -620,9 +714,10 @@ private:
   typedef std::vector<FullMacLowDcfListener *> DcfListeners;
   DcfListeners m_dcfListeners;
 
-  EventId m_normalAckTimeoutEvent;
-  EventId m_fastAckTimeoutEvent;
-  EventId m_superFastAckTimeoutEvent;
+  FullMacLowTimers m_timers;           //!< the ACK timeouts, which UpdateDuplexEnd extends
+  uint32_t m_normalAckTimeout;
+  uint32_t m_fastAckTimeout;
+  uint32_t m_superFastAckTimeout;
   EventId m_fastAckFailedTimeoutEvent;
   EventId m_blockAckTimeoutEvent;
   EventId m_ctsTimeoutEvent;
@@ -633,8 +728,10 @@ private:
   EventId m_endTxNoAckEvent;
   EventId m_navCounterResetCtsMissed;
 
-  Ptr<Packet> m_currentPacket;
+  Ptr<const Packet> m_currentPacket;    //!< payload of the current frame, shared with the caller
   FullWifiMacHeader m_currentHdr;
+  Ptr<const FullWifiRxFrame> m_rxFrame;   //!< the frame being received
+  FullCtrlFrameFactory m_ctrlFrames;      //!< templates of the ACK, CTS, RTS and busy tone frames
   FullMacLowTransmissionParameters m_txParams;
   FullMacLowTransmissionListener *m_listener;
   Mac48Address m_self;
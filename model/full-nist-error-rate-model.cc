@@ -76,34 +76,6 @@ FullNistErrorRateModel::Get64QamBer (double snr) const
   return ber;
 }
 double
-FullNistErrorRateModel::GetFecBpskBer (double snr, double nbits,
-                                   uint32_t bValue) const
-{
-  double ber = GetBpskBer (snr);
-  if (ber == 0.0)
-    {
-      return 1.0;
-    }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, nbits);
-  return pms;
-}
-double
-FullNistErrorRateModel::GetFecQpskBer (double snr, double nbits,
-                                   uint32_t bValue) const
-{
-  double ber = GetQpskBer (snr);
-  if (ber == 0.0)
-    {
-      return 1.0;
-    }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, nbits);
-  return pms;
-}
-double
 FullNistErrorRateModel::CalculatePe (double p, uint32_t bValue) const
 {
   double D = std::sqrt (4.0 * p * (1.0 - p));
@@ -162,107 +134,53 @@ FullNistErrorRateModel::CalculatePe (double p, uint32_t bValue) const
 }
 
 double
-FullNistErrorRateModel::GetFec16QamBer (double snr, uint32_t nbits,
-                                    uint32_t bValue) const
+FullNistErrorRateModel::DoGetCodedBitErrorRate (FullWifiMode mode, double snr) const
 {
-  double ber = Get16QamBer (snr);
-  if (ber == 0.0)
+  if (mode.GetModulationClass () != FULL_WIFI_MOD_CLASS_ERP_OFDM
+      && mode.GetModulationClass () != FULL_WIFI_MOD_CLASS_OFDM)
     {
-      return 1.0;
+      return -1.0;
+    }
+  double ber;
+  uint32_t bValue;
+  if (mode.GetConstellationSize () == 2)
+    {
+      ber = GetBpskBer (snr);
+      bValue = mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2 ? 1 : 3;
+    }
+  else if (mode.GetConstellationSize () == 4)
+    {
+      ber = GetQpskBer (snr);
+      bValue = mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2 ? 1 : 3;
+    }
+  else if (mode.GetConstellationSize () == 16)
+    {
+      ber = Get16QamBer (snr);
+      bValue = mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2 ? 1 : 3;
+    }
+  else if (mode.GetConstellationSize () == 64)
+    {
+      ber = Get64QamBer (snr);
+      bValue = mode.GetCodeRate () == FULL_WIFI_CODE_RATE_2_3 ? 2 : 3;
+    }
+  else
+    {
+      return -1.0;
     }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, static_cast<double> (nbits));
-  return pms;
-}
-double
-FullNistErrorRateModel::GetFec64QamBer (double snr, uint32_t nbits,
-                                    uint32_t bValue) const
-{
-  double ber = Get64QamBer (snr);
   if (ber == 0.0)
     {
-      return 1.0;
+      return 0.0;
     }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, static_cast<double> (nbits));
-  return pms;
+  return CalculatePe (ber, bValue);
 }
+
 double
 FullNistErrorRateModel::GetChunkSuccessRate (FullWifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == FULL_WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == FULL_WIFI_MOD_CLASS_OFDM)
     {
-      if (mode.GetConstellationSize () == 2)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    1 // b value
-                                    );
-            }
-          else
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    3 // b value
-                                    );
-            }
-        }
-      else if (mode.GetConstellationSize () == 4)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQpskBer (snr,
-                                    nbits,
-                                    1 // b value
-                                    );
-            }
-          else
-            {
-              return GetFecQpskBer (snr,
-                                    nbits,
-                                    3 // b value
-                                    );
-            }
-        }
-      else if (mode.GetConstellationSize () == 16)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
-            {
-              return GetFec16QamBer (snr,
-                                     nbits,
-                                     1 // b value
-                                     );
-            }
-          else
-            {
-              return GetFec16QamBer (snr,
-                                     nbits,
-                                     3 // b value
-                                     );
-            }
-        }
-      else if (mode.GetConstellationSize () == 64)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_2_3)
-            {
-              return GetFec64QamBer (snr,
-                                     nbits,
-                                     2 // b value
-                                     );
-            }
-          else
-            {
-              return GetFec64QamBer (snr,
-                                     nbits,
-                                     3 // b value
-                                     );
-            }
-        }
+      return GetCodedChunkSuccessRate (mode, snr, nbits);
     }
   else if (mode.GetModulationClass () == FULL_WIFI_MOD_CLASS_DSSS)
     {
@@ -50,14 +50,13 @@ private:
   double GetQpskBer (double snr) const;
   double Get16QamBer (double snr) const;
   double Get64QamBer (double snr) const;
-  double GetFecBpskBer (double snr, double nbits,
-                        uint32_t bValue) const;
-  double GetFecQpskBer (double snr, double nbits,
-                        uint32_t bValue) const;
-  double GetFec16QamBer (double snr, uint32_t nbits,
-                         uint32_t bValue) const;
-  double GetFec64QamBer (double snr, uint32_t nbits,
-                         uint32_t bValue) const;
+  /**
+   * \param mode a coded OFDM mode
+   * \param snr the snr (linear)
+   * \returns the bit error rate after decoding, or a negative value for
+   *          the other modes
+   */
+  virtual double DoGetCodedBitErrorRate (FullWifiMode mode, double snr) const;
 };
 
 
@@ -419,6 +419,11 @@ FullRegularWifiMac::SetForwardQueue (Ptr<ForwardQueue> forwardQueue)
 {
   m_dca->SetForwardQueue (forwardQueue);
 }
+void
+FullRegularWifiMac::SetReturnPacketPolicy (Ptr<FullReturnPacketPolicy> policy)
+{
+  m_dca->SetReturnPacketPolicy (policy);
+}
 bool
 FullRegularWifiMac::GetEnableBusyTone (void) const
 {
@@ -439,6 +444,11 @@ FullRegularWifiMac::GetForwardQueue (void) const
 {
   return m_dca->GetForwardQueue ();
 }
+Ptr<FullReturnPacketPolicy>
+FullRegularWifiMac::GetReturnPacketPolicy (void) const
+{
+  return m_dca->GetReturnPacketPolicy ();
+}
 
 
 
@@ -676,6 +686,12 @@ FullRegularWifiMac::GetTypeId (void)
                   MakePointerAccessor (&FullRegularWifiMac::SetForwardQueue,
                                        &FullRegularWifiMac::GetForwardQueue),
                   MakePointerChecker<ForwardQueue> ())
+   .AddAttribute ("ReturnPacketPolicy",
+                  "How to choose the return or forward packet among the packets queued for its destination",
+                  PointerValue (),
+                  MakePointerAccessor (&FullRegularWifiMac::SetReturnPacketPolicy,
+                                       &FullRegularWifiMac::GetReturnPacketPolicy),
+                  MakePointerChecker<FullReturnPacketPolicy> ())
     .AddAttribute ("DcaTxop", "The DcaTxop object",
                    PointerValue (),
                    MakePointerAccessor (&FullRegularWifiMac::GetDcaTxop),
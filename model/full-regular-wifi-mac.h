@@ -211,6 +211,7 @@ public:
   virtual Time GetCompressedBlockAckTimeout (void) const;
 
   void SetForwardQueue (Ptr<ForwardQueue> forwardingQueue);
+  void SetReturnPacketPolicy (Ptr<FullReturnPacketPolicy> policy);
 
 protected:
   virtual void DoInitialize ();
@@ -333,6 +334,7 @@ protected:
   bool GetEnableReturnPacket (void) const;
   bool GetEnableForward (void) const;
   Ptr<ForwardQueue> GetForwardQueue (void) const;
+  Ptr<FullReturnPacketPolicy> GetReturnPacketPolicy (void) const;
 
 private:
   FullRegularWifiMac (const FullRegularWifiMac &);
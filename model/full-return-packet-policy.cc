@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "full-return-packet-policy.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (FullReturnPacketPolicy);
+NS_OBJECT_ENSURE_REGISTERED (FullFirstReturnPacketPolicy);
+NS_OBJECT_ENSURE_REGISTERED (FullBestFitReturnPacketPolicy);
+NS_OBJECT_ENSURE_REGISTERED (FullFirstFitReturnPacketPolicy);
+
+TypeId
+FullReturnPacketPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FullReturnPacketPolicy")
+    .SetParent<Object> ()
+  ;
+  return tid;
+}
+
+TypeId
+FullFirstReturnPacketPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FullFirstReturnPacketPolicy")
+    .SetParent<FullReturnPacketPolicy> ()
+    .AddConstructor<FullFirstReturnPacketPolicy> ()
+  ;
+  return tid;
+}
+
+uint32_t
+FullFirstReturnPacketPolicy::GetMaxCandidates (void) const
+{
+  return 1;
+}
+
+uint32_t
+FullFirstReturnPacketPolicy::Select (const std::vector<Time> &durations, Time remaining) const
+{
+  return 0;
+}
+
+TypeId
+FullBestFitReturnPacketPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FullBestFitReturnPacketPolicy")
+    .SetParent<FullReturnPacketPolicy> ()
+    .AddConstructor<FullBestFitReturnPacketPolicy> ()
+    .AddAttribute ("MaxCandidates",
+                   "The number of queued packets, starting from the oldest, to choose from.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&FullBestFitReturnPacketPolicy::m_maxCandidates),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+FullBestFitReturnPacketPolicy::FullBestFitReturnPacketPolicy ()
+  : m_maxCandidates (8)
+{
+}
+
+uint32_t
+FullBestFitReturnPacketPolicy::GetMaxCandidates (void) const
+{
+  return m_maxCandidates;
+}
+
+uint32_t
+FullBestFitReturnPacketPolicy::Select (const std::vector<Time> &durations, Time remaining) const
+{
+  NS_ASSERT (!durations.empty ());
+  uint32_t longestFit = durations.size ();
+  uint32_t shortest = 0;
+  for (uint32_t i = 0; i < durations.size (); i++)
+    {
+      if (durations[i] <= remaining
+          && (longestFit == durations.size () || durations[i] > durations[longestFit]))
+        {
+          longestFit = i;
+        }
+      if (durations[i] < durations[shortest])
+        {
+          shortest = i;
+        }
+    }
+  return longestFit != durations.size () ? longestFit : shortest;
+}
+
+TypeId
+FullFirstFitReturnPacketPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FullFirstFitReturnPacketPolicy")
+    .SetParent<FullBestFitReturnPacketPolicy> ()
+    .AddConstructor<FullFirstFitReturnPacketPolicy> ()
+    .AddAttribute ("Slack",
+                   "A packet which ends at most this long before the primary frame is sent right away.",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&FullFirstFitReturnPacketPolicy::m_slack),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+FullFirstFitReturnPacketPolicy::FullFirstFitReturnPacketPolicy ()
+  : m_slack (MicroSeconds (100))
+{
+}
+
+uint32_t
+FullFirstFitReturnPacketPolicy::Select (const std::vector<Time> &durations, Time remaining) const
+{
+  for (uint32_t i = 0; i < durations.size (); i++)
+    {
+      if (durations[i] <= remaining && durations[i] + m_slack >= remaining)
+        {
+          return i;
+        }
+    }
+  return FullBestFitReturnPacketPolicy::Select (durations, remaining);
+}
+
+} // namespace ns3
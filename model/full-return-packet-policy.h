@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FULL_RETURN_PACKET_POLICY_H
+#define FULL_RETURN_PACKET_POLICY_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief choose the return or forward packet sent during a reception
+ *
+ * When FullDcaTxop starts a secondary transmission while it receives a
+ * data frame, it hands the first GetMaxCandidates packets queued for the
+ * secondary receiver, in FIFO order, to the policy along with their
+ * transmission durations and with what is left of the primary frame.
+ */
+class FullReturnPacketPolicy : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * \return the maximum number of queued packets to choose from
+   */
+  virtual uint32_t GetMaxCandidates (void) const = 0;
+  /**
+   * \param durations the transmission durations of the candidates, in
+   *        FIFO order; there is at least one
+   * \param remaining the time left until the end of the primary frame
+   * \return the index of the candidate to send
+   */
+  virtual uint32_t Select (const std::vector<Time> &durations, Time remaining) const = 0;
+};
+
+/**
+ * \ingroup wifi
+ * \brief send the first queued packet, whatever its length
+ */
+class FullFirstReturnPacketPolicy : public FullReturnPacketPolicy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  virtual uint32_t GetMaxCandidates (void) const;
+  virtual uint32_t Select (const std::vector<Time> &durations, Time remaining) const;
+};
+
+/**
+ * \ingroup wifi
+ * \brief send the longest packet which ends with the primary frame
+ *
+ * If none of the candidates fits, the shortest one is sent.
+ */
+class FullBestFitReturnPacketPolicy : public FullReturnPacketPolicy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  FullBestFitReturnPacketPolicy ();
+
+  virtual uint32_t GetMaxCandidates (void) const;
+  virtual uint32_t Select (const std::vector<Time> &durations, Time remaining) const;
+
+private:
+  uint32_t m_maxCandidates;
+};
+
+/**
+ * \ingroup wifi
+ * \brief send the first packet which ends less than Slack before the
+ *        primary frame
+ *
+ * If none of the candidates is that close, the best fit is sent.
+ */
+class FullFirstFitReturnPacketPolicy : public FullBestFitReturnPacketPolicy
+{
+public:
+  static TypeId GetTypeId (void);
+
+  FullFirstFitReturnPacketPolicy ();
+
+  virtual uint32_t Select (const std::vector<Time> &durations, Time remaining) const;
+
+private:
+  Time m_slack;
+};
+
+} // namespace ns3
+
+#endif /* FULL_RETURN_PACKET_POLICY_H */
@@ -1197,4 +1197,18 @@ FullWifiMacHeader::Deserialize (Buffer::Iterator start)
   return i.GetDistanceFrom (start);
 }
 
+std::size_t
+FullMac48AddressHash::operator() (const Mac48Address &address) const
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  // FNV-1a
+  std::size_t hash = 2166136261u;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      hash = (hash ^ buffer[i]) * 16777619u;
+    }
+  return hash;
+}
+
 } // namespace ns3
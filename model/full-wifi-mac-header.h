@@ -26,9 +26,19 @@
 #include "ns3/mac48-address.h"
 #include "ns3/nstime.h"
 #include <stdint.h>
+#include <cstddef>
 
 namespace ns3 {
 
+/**
+ * Hash of a Mac48Address, computed from its six bytes, for the
+ * std::unordered_map indexes of the MAC.
+ */
+struct FullMac48AddressHash
+{
+  std::size_t operator() (const Mac48Address &address) const;
+};
+
 enum FullWifiMacType
 {
   FULL_WIFI_MAC_CTL_RTS = 0,
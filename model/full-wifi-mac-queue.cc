@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/assert.h"
 
 #include "full-wifi-mac-queue.h"
 #include "full-qos-blocked-destinations.h"
@@ -59,7 +60,8 @@ FullWifiMacQueue::GetTypeId (void)
 }
 
 FullWifiMacQueue::FullWifiMacQueue ()
-  : m_size (0)
+  : m_headId (0),
+    m_size (0)
 {
 }
 
@@ -100,34 +102,122 @@ FullWifiMacQueue::Enqueue (Ptr<const Packet> packet, const FullWifiMacHeader &hd
     {
       return;
     }
+  Insert (packet, hdr, false);
+}
+
+void
+FullWifiMacQueue::Insert (Ptr<const Packet> packet, const FullWifiMacHeader &hdr, bool front)
+{
   Time now = Simulator::Now ();
-  m_queue.push_back (FullItem (packet, hdr, now));
+  int64_t id;
+  struct FullDestination &destination = m_destinations[hdr.GetAddr1 ()];
+  std::deque<int64_t> &positions = destination.positions;
+  if (front)
+    {
+      m_queue.push_front (FullItem (packet, hdr, now));
+      id = --m_headId;
+      positions.push_front (id);
+    }
+  else
+    {
+      m_queue.push_back (FullItem (packet, hdr, now));
+      id = m_headId + static_cast<int64_t> (m_queue.size ()) - 1;
+      positions.push_back (id);
+    }
+  /* packets are timestamped when they are inserted, at either end, so
+   * that m_expiry stays sorted by timestamp. */
+  m_expiry.push_back (FullExpiry (id, now));
+  destination.size++;
   m_size++;
 }
 
 void
-FullWifiMacQueue::Cleanup (void)
+FullWifiMacQueue::Erase (PacketQueueI it)
 {
-  if (m_queue.empty ())
+  NS_ASSERT (it->packet != 0);
+  it->packet = 0;
+  m_size--;
+  DestinationIndex::iterator d = m_destinations.find (it->hdr.GetAddr1 ());
+  NS_ASSERT (d != m_destinations.end () && d->second.size > 0);
+  if (--d->second.size == 0)
     {
-      return;
+      m_destinations.erase (d);
     }
+  else
+    {
+      /* in FIFO order the packet is the first of its destination: drop
+       * its position now rather than on the next lookup. */
+      FindByDestination (it->hdr.GetAddr1 ());
+    }
+  while (!m_queue.empty () && m_queue.front ().packet == 0)
+    {
+      m_queue.pop_front ();
+      m_headId++;
+    }
+}
 
-  Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end ();)
+FullWifiMacQueue::PacketQueueI
+FullWifiMacQueue::Head (void)
+{
+  NS_ASSERT (m_queue.empty () || m_queue.front ().packet != 0);
+  return m_queue.begin ();
+}
+
+FullWifiMacQueue::PacketQueueI
+FullWifiMacQueue::Find (int64_t id)
+{
+  int64_t index = id - m_headId;
+  if (index < 0 || index >= static_cast<int64_t> (m_queue.size ())
+      || m_queue[index].packet == 0)
+    {
+      return m_queue.end ();
+    }
+  return m_queue.begin () + index;
+}
+
+FullWifiMacQueue::PacketQueueI
+FullWifiMacQueue::FindByDestination (Mac48Address addr)
+{
+  DestinationIndex::iterator d = m_destinations.find (addr);
+  if (d == m_destinations.end ())
+    {
+      return m_queue.end ();
+    }
+  /* a position is reused when PushFront moves the head back over it,
+   * so check the destination as well. */
+  std::deque<int64_t> &positions = d->second.positions;
+  while (!positions.empty ())
     {
-      if (i->tstamp + m_maxDelay > now)
+      PacketQueueI it = Find (positions.front ());
+      if (it != m_queue.end () && it->hdr.GetAddr1 () == addr)
         {
-          i++;
+          return it;
         }
-      else
+      positions.pop_front ();
+    }
+  NS_ASSERT_MSG (false, "a destination with queued packets has no valid position");
+  return m_queue.end ();
+}
+
+void
+FullWifiMacQueue::Cleanup (void)
+{
+  Time now = Simulator::Now ();
+  while (!m_expiry.empty ())
+    {
+      const FullExpiry &e = m_expiry.front ();
+      PacketQueueI it = Find (e.id);
+      if (it != m_queue.end () && it->tstamp == e.tstamp)
         {
-          i = m_queue.erase (i);
-          n++;
+          if (e.tstamp + m_maxDelay > now)
+            {
+              return;
+            }
+          Erase (it);
         }
+      /* the packet has expired, or it left the queue earlier */
+      m_expiry.pop_front ();
     }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -136,11 +226,11 @@ FullWifiMacQueue::Dequeue (FullWifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      FullItem i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
-      *hdr = i.hdr;
-      return i.packet;
+      PacketQueueI it = Head ();
+      Ptr<const Packet> packet = it->packet;
+      *hdr = it->hdr;
+      Erase (it);
+      return packet;
     }
   return 0;
 }
@@ -151,9 +241,9 @@ FullWifiMacQueue::Peek (FullWifiMacHeader *hdr)
   Cleanup ();
   if (!m_queue.empty ())
     {
-      FullItem i = m_queue.front ();
-      *hdr = i.hdr;
-      return i.packet;
+      PacketQueueI it = Head ();
+      *hdr = it->hdr;
+      return it->packet;
     }
   return 0;
 }
@@ -170,15 +260,14 @@ FullWifiMacQueue::DequeueByTidAndAddress (FullWifiMacHeader *hdr, uint8_t tid,
       NS_ASSERT (type <= 4);
       for (it = m_queue.begin (); it != m_queue.end (); ++it)
         {
-          if (it->hdr.IsQosData ())
+          if (it->packet != 0 && it->hdr.IsQosData ())
             {
               if (GetAddressForPacket (type, it) == dest
                   && it->hdr.GetQosTid () == tid)
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
+                  Erase (it);
                   break;
                 }
             }
@@ -198,7 +287,7 @@ FullWifiMacQueue::PeekByTidAndAddress (FullWifiMacHeader *hdr, uint8_t tid,
       NS_ASSERT (type <= 4);
       for (it = m_queue.begin (); it != m_queue.end (); ++it)
         {
-          if (it->hdr.IsQosData ())
+          if (it->packet != 0 && it->hdr.IsQosData ())
             {
               if (GetAddressForPacket (type, it) == dest
                   && it->hdr.GetQosTid () == tid)
@@ -228,7 +317,9 @@ FullWifiMacQueue::GetSize (void)
 void
 FullWifiMacQueue::Flush (void)
 {
-  m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_queue.clear ();
+  m_expiry.clear ();
+  m_destinations.clear ();
   m_size = 0;
 }
 
@@ -256,10 +347,9 @@ FullWifiMacQueue::Remove (Ptr<const Packet> packet)
   PacketQueueI it = m_queue.begin ();
   for (; it != m_queue.end (); it++)
     {
-      if (it->packet == packet)
+      if (it->packet != 0 && it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -274,43 +364,86 @@ FullWifiMacQueue::PushFront (Ptr<const Packet> packet, const FullWifiMacHeader &
     {
       return;
     }
-  Time now = Simulator::Now ();
-  m_queue.push_front (FullItem (packet, hdr, now));
-  m_size++;
+  Insert (packet, hdr, true);
 }
 
 Ptr<const Packet>
 FullWifiMacQueue::DequeueFirstAvailable (FullWifiMacHeader *hdr, Mac48Address src)
 {
-  PacketQueueI it = m_queue.begin ();
-  Ptr<const Packet> packet = 0;
-  for (; it != m_queue.end (); it++)
+  PacketQueueI it = FindByDestination (src);
+  if (it == m_queue.end ())
     {
-      if (it->hdr.GetAddr1 () == src)
-        {
-          *hdr = it->hdr;
-          packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
-          return packet;
-        }
+      return 0;
     }
-  return 0;
+  *hdr = it->hdr;
+  Ptr<const Packet> packet = it->packet;
+  Erase (it);
+  return packet;
 }
 
 Ptr<const Packet>
 FullWifiMacQueue::PeekFirstAvailable (FullWifiMacHeader *hdr, Mac48Address src)
 {
-  PacketQueueI it = m_queue.begin ();
-  for (; it != m_queue.end (); it++)
+  PacketQueueI it = FindByDestination (src);
+  if (it == m_queue.end ())
+    {
+      return 0;
+    }
+  *hdr = it->hdr;
+  return it->packet;
+}
+
+void
+FullWifiMacQueue::PeekByDestination (Mac48Address dest, uint32_t max,
+                                     std::vector<Ptr<const Packet> > *packets,
+                                     std::vector<FullWifiMacHeader> *hdrs)
+{
+  packets->clear ();
+  hdrs->clear ();
+  if (FindByDestination (dest) == m_queue.end ())
     {
-      if (it->hdr.GetAddr1 () == src)
+      return;
+    }
+  /* the positions of the packets still queued increase along the index;
+   * a position reused by PushFront may appear twice. */
+  const std::deque<int64_t> &positions = m_destinations[dest].positions;
+  int64_t last = m_headId - 1;
+  for (std::deque<int64_t>::const_iterator i = positions.begin ();
+       i != positions.end () && packets->size () < max; ++i)
+    {
+      if (*i <= last)
         {
-          *hdr = it->hdr;
-          return it->packet;
+          continue;
+        }
+      PacketQueueI it = Find (*i);
+      if (it != m_queue.end () && it->hdr.GetAddr1 () == dest)
+        {
+          packets->push_back (it->packet);
+          hdrs->push_back (it->hdr);
+          last = *i;
         }
     }
-  return 0;
+}
+
+bool
+FullWifiMacQueue::RemoveByDestination (Mac48Address dest, Ptr<const Packet> packet)
+{
+  DestinationIndex::iterator d = m_destinations.find (dest);
+  if (d == m_destinations.end () || packet == 0)
+    {
+      return false;
+    }
+  const std::deque<int64_t> &positions = d->second.positions;
+  for (std::deque<int64_t>::const_iterator i = positions.begin (); i != positions.end (); ++i)
+    {
+      PacketQueueI it = Find (*i);
+      if (it != m_queue.end () && it->packet == packet)
+        {
+          Erase (it);
+          return true;
+        }
+    }
+  return false;
 }
 
 uint32_t
@@ -325,7 +458,7 @@ FullWifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, FullWifiMacHeader::Ad
       NS_ASSERT (type <= 4);
       for (it = m_queue.begin (); it != m_queue.end (); it++)
         {
-          if (GetAddressForPacket (type, it) == addr)
+          if (it->packet != 0 && GetAddressForPacket (type, it) == addr)
             {
               if (it->hdr.IsQosData () && it->hdr.GetQosTid () == tid)
                 {
@@ -345,14 +478,14 @@ FullWifiMacQueue::DequeueFirstAvailable (FullWifiMacHeader *hdr, Time &timestamp
   Ptr<const Packet> packet = 0;
   for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
     {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
+      if (it->packet != 0
+          && (!it->hdr.IsQosData ()
+              || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ())))
         {
           *hdr = it->hdr;
           timestamp = it->tstamp;
           packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return packet;
         }
     }
@@ -366,8 +499,9 @@ FullWifiMacQueue::PeekFirstAvailable (FullWifiMacHeader *hdr, Time &timestamp,
   Cleanup ();
   for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
     {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
+      if (it->packet != 0
+          && (!it->hdr.IsQosData ()
+              || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ())))
         {
           *hdr = it->hdr;
           timestamp = it->tstamp;
@@ -22,7 +22,9 @@
 #ifndef FULL_WIFI_MAC_QUEUE_H
 #define FULL_WIFI_MAC_QUEUE_H
 
-#include <list>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
@@ -48,6 +50,18 @@ class FullQosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Packets are kept in a deque in FIFO order. A packet removed from the
+ * middle of the queue only leaves an empty slot, which is reclaimed once
+ * it reaches the head; positions are only ever reused by PushFront. The
+ * timestamps are kept apart, in the order the packets were inserted,
+ * which is also their expiry order: expired packets are found by looking
+ * at the head of that list only.
+ *
+ * The positions of the packets are also indexed by Addr1, so that the
+ * full-duplex return packet for a given station is found without
+ * scanning the whole queue. The entry of a destination is erased as soon
+ * as its last packet leaves the queue.
  */
 class FullWifiMacQueue : public Object
 {
@@ -120,9 +134,28 @@ public:
   /**
    * Check to see if there is a packet for the given destination
    * Return the first available packet and remove it
+   *
+   * This uses the per-destination index and does not scan the queue.
    */
   Ptr<const Packet> DequeueFirstAvailable (FullWifiMacHeader *hdr, Mac48Address src);
   Ptr<const Packet> PeekFirstAvailable (FullWifiMacHeader *hdr, Mac48Address src);
+  /**
+   * Lists the first packets queued for the given destination, in FIFO
+   * order, without removing them.
+   *
+   * \param dest the Addr1 of the packets
+   * \param max the maximum number of packets to list
+   * \param packets cleared, then filled with the packets
+   * \param hdrs cleared, then filled with their headers
+   */
+  void PeekByDestination (Mac48Address dest, uint32_t max,
+                          std::vector<Ptr<const Packet> > *packets,
+                          std::vector<FullWifiMacHeader> *hdrs);
+  /**
+   * Same as Remove, for a packet queued for <i>dest</i>: only the packets
+   * for that destination are searched.
+   */
+  bool RemoveByDestination (Mac48Address dest, Ptr<const Packet> packet);
 
   void Flush (void);
 
@@ -130,12 +163,40 @@ public:
   uint32_t GetSize (void);
 private:
   struct FullItem;
+  struct FullExpiry;
+  struct FullDestination;
 
-  typedef std::list<struct FullItem> PacketQueue;
-  typedef std::list<struct FullItem>::reverse_iterator PacketQueueRI;
-  typedef std::list<struct FullItem>::iterator PacketQueueI;
+  typedef std::deque<struct FullItem> PacketQueue;
+  typedef std::deque<struct FullItem>::reverse_iterator PacketQueueRI;
+  typedef std::deque<struct FullItem>::iterator PacketQueueI;
+  typedef std::deque<struct FullExpiry> ExpiryQueue;
+  typedef std::unordered_map<Mac48Address, struct FullDestination, FullMac48AddressHash> DestinationIndex;
 
   void Cleanup (void);
+  /**
+   * Insert a packet at either end of the queue.
+   */
+  void Insert (Ptr<const Packet> packet, const FullWifiMacHeader &hdr, bool front);
+  /**
+   * Empty the slot of a packet and reclaim the empty slots at the head.
+   */
+  void Erase (PacketQueueI it);
+  /**
+   * \return the first packet which was not removed, or m_queue.end ()
+   */
+  PacketQueueI Head (void);
+  /**
+   * \return the packet at position id, or m_queue.end () if that packet
+   *         was removed
+   */
+  PacketQueueI Find (int64_t id);
+  /**
+   * \return the first packet queued for addr, or m_queue.end ()
+   *
+   * Drops the positions of removed packets from the front of the
+   * positions of addr on the way.
+   */
+  PacketQueueI FindByDestination (Mac48Address addr);
   Mac48Address GetAddressForPacket (enum FullWifiMacHeader::AddressType type, PacketQueueI);
 
   struct FullItem
@@ -143,12 +204,31 @@ private:
     FullItem (Ptr<const Packet> packet,
           const FullWifiMacHeader &hdr,
           Time tstamp);
-    Ptr<const Packet> packet;
+    Ptr<const Packet> packet;   //!< 0 once the packet has been removed
     FullWifiMacHeader hdr;
     Time tstamp;
   };
 
+  struct FullExpiry
+  {
+    FullExpiry (int64_t id, Time tstamp)
+      : id (id), tstamp (tstamp) {}
+    int64_t id;                 //!< position of the packet, see m_headId
+    Time tstamp;
+  };
+
+  struct FullDestination
+  {
+    FullDestination ()
+      : size (0) {}
+    std::deque<int64_t> positions;  //!< in FIFO order, may hold positions of removed packets
+    uint32_t size;                  //!< number of packets still queued
+  };
+
   PacketQueue m_queue;
+  int64_t m_headId;             //!< position of m_queue.front (), which PushFront decrements
+  ExpiryQueue m_expiry;         //!< one entry per inserted packet, oldest first
+  DestinationIndex m_destinations;  //!< positions of the packets of each Addr1, in FIFO order
   FullWifiMacParameters *m_parameters;
   uint32_t m_size;
   uint32_t m_maxSize;
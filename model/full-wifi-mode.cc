@@ -112,6 +112,16 @@ ATTRIBUTE_HELPER_CPP (FullWifiMode);
 
 FullWifiModeFactory::FullWifiModeFactory ()
 {
+  uint32_t uid = AllocateUid ("Invalid-WifiMode");
+  FullWifiModeItem *item = Get (uid);
+  item->uniqueUid = "Invalid-WifiMode";
+  item->bandwidth = 0;
+  item->dataRate = 0;
+  item->phyRate = 0;
+  item->modClass = FULL_WIFI_MOD_CLASS_UNKNOWN;
+  item->constellationSize = 0;
+  item->codingRate = FULL_WIFI_CODE_RATE_UNDEFINED;
+  item->isMandatory = false;
 }
 
 
@@ -173,17 +183,12 @@ FullWifiModeFactory::CreateWifiMode (std::string uniqueName,
 }
 
 FullWifiMode
-FullWifiModeFactory::Search (std::string name)
+FullWifiModeFactory::Search (const std::string &name)
 {
-  FullWifiModeItemList::const_iterator i;
-  uint32_t j = 0;
-  for (i = m_itemList.begin (); i != m_itemList.end (); i++)
+  FullWifiModeNames::const_iterator found = m_names.find (name);
+  if (found != m_names.end ())
     {
-      if (i->uniqueUid == name)
-        {
-          return FullWifiMode (j);
-        }
-      j++;
+      return FullWifiMode (found->second);
     }
 
   // If we get here then a matching WifiMode was not found above. This
@@ -191,7 +196,7 @@ FullWifiModeFactory::Search (std::string name)
   // list of WifiModes that are supported.
   NS_LOG_UNCOND ("Could not find match for WifiMode named \""
                  << name << "\". Valid options are:");
-  for (i = m_itemList.begin (); i != m_itemList.end (); i++)
+  for (FullWifiModeItemList::const_iterator i = m_itemList.begin (); i != m_itemList.end (); i++)
     {
       NS_LOG_UNCOND ("  " << i->uniqueUid);
     }
@@ -208,20 +213,16 @@ FullWifiModeFactory::Search (std::string name)
 }
 
 uint32_t
-FullWifiModeFactory::AllocateUid (std::string uniqueUid)
+FullWifiModeFactory::AllocateUid (const std::string &uniqueUid)
 {
-  uint32_t j = 0;
-  for (FullWifiModeItemList::const_iterator i = m_itemList.begin ();
-       i != m_itemList.end (); i++)
+  FullWifiModeNames::const_iterator found = m_names.find (uniqueUid);
+  if (found != m_names.end ())
     {
-      if (i->uniqueUid == uniqueUid)
-        {
-          return j;
-        }
-      j++;
+      return found->second;
     }
   uint32_t uid = m_itemList.size ();
   m_itemList.push_back (FullWifiModeItem ());
+  m_names[uniqueUid] = uid;
   return uid;
 }
 
@@ -235,22 +236,9 @@ FullWifiModeFactory::Get (uint32_t uid)
 FullWifiModeFactory *
 FullWifiModeFactory::GetFactory (void)
 {
-  static bool isFirstTime = true;
+  // the invalid mode is registered by the constructor, so that the
+  // getters of FullWifiMode only pay for an array index
   static FullWifiModeFactory factory;
-  if (isFirstTime)
-    {
-      uint32_t uid = factory.AllocateUid ("Invalid-WifiMode");
-      FullWifiModeItem *item = factory.Get (uid);
-      item->uniqueUid = "Invalid-WifiMode";
-      item->bandwidth = 0;
-      item->dataRate = 0;
-      item->phyRate = 0;
-      item->modClass = FULL_WIFI_MOD_CLASS_UNKNOWN;
-      item->constellationSize = 0;
-      item->codingRate = FULL_WIFI_CODE_RATE_UNDEFINED;
-      item->isMandatory = false;
-      isFirstTime = false;
-    }
   return &factory;
 }
 
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <ostream>
 #include "ns3/attribute-helper.h"
 #include "ns3/full-wifi-phy-standard.h"
@@ -231,12 +232,14 @@ private:
     bool isMandatory;
   };
 
-  FullWifiMode Search (std::string name);
-  uint32_t AllocateUid (std::string uniqueName);
+  FullWifiMode Search (const std::string &name);
+  uint32_t AllocateUid (const std::string &uniqueName);
   FullWifiModeItem* Get (uint32_t uid);
 
   typedef std::vector<struct FullWifiModeItem> FullWifiModeItemList;
-  FullWifiModeItemList m_itemList;
+  typedef std::unordered_map<std::string, uint32_t> FullWifiModeNames;
+  FullWifiModeItemList m_itemList;  //!< items indexed by uid
+  FullWifiModeNames m_names;        //!< uid of each unique name
 };
 
 } // namespace ns3
@@ -191,11 +191,11 @@ FullWifiPhyStateHelper::NotifyTxStart (Time duration)
     }
 }
 void
-FullWifiPhyStateHelper::NotifyRxStart (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+FullWifiPhyStateHelper::NotifyRxStart (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
 {
   for (Listeners::const_iterator i = m_listeners.begin (); i != m_listeners.end (); i++)
     {
-      (*i)->NotifyRxStart (duration, packet, txMode, preamble);
+      (*i)->NotifyRxStart (duration, frame, txMode, preamble);
     }
 }
 void
@@ -289,11 +289,11 @@ FullWifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, F
   m_startTx = now;
 }
 void
-FullWifiPhyStateHelper::SwitchToRx (Time rxDuration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+FullWifiPhyStateHelper::SwitchToRx (Time rxDuration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
 {
   NS_ASSERT (IsStateIdle () || IsStateCcaBusy ());
   NS_ASSERT (!m_rxing);
-  NotifyRxStart (rxDuration, packet, txMode, preamble);
+  NotifyRxStart (rxDuration, frame, txMode, preamble);
   Time now = Simulator::Now ();
   switch (GetState ())
     {
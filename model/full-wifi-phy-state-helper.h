@@ -54,7 +54,7 @@ public:
   Time GetLastRxStartTime (void) const;
 
   void SwitchToTx (Time txDuration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble, uint8_t txPower);
-  void SwitchToRx (Time rxDuration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble);
+  void SwitchToRx (Time rxDuration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble);
   void SwitchToChannelSwitching (Time switchingDuration);
   void SwitchFromRxEndOk (Ptr<Packet> packet, double snr, FullWifiMode mode, enum FullWifiPreamble preamble);
   void SwitchFromRxEndError (Ptr<const Packet> packet, double snr);
@@ -68,7 +68,7 @@ private:
 
   void NotifyTxStart (Time duration);
   void NotifyWakeup (void);
-  void NotifyRxStart (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble);
+  void NotifyRxStart (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble);
   void NotifyRxEndOk (void);
   void NotifyRxEndError (void);
   void NotifyMaybeCcaBusyStart (Time duration);
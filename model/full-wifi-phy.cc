@@ -31,6 +31,7 @@
 #include "ns3/enum.h"
 #include "ns3/trace-source-accessor.h"
 #include <cmath>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE ("FullWifiPhy");
 
@@ -290,13 +291,57 @@ FullWifiPhy::GetPayloadDurationMicroSeconds (uint32_t size, FullWifiMode payload
     }
 }
 
+/**
+ * Durations (us) of the frames shorter than TX_DURATION_CACHE_SIZE bytes,
+ * one row per mode and preamble. A row is allocated the first time its
+ * mode and preamble are used and its entries are filled on demand; 0
+ * marks an entry not computed yet since a PLCP preamble is never empty.
+ */
+static const uint32_t TX_DURATION_CACHE_SIZE = 4096;
+static std::vector<std::vector<uint32_t> > g_txDurations;
+
+static uint32_t
+ComputeTxDurationMicroSeconds (uint32_t size, FullWifiMode payloadMode, FullWifiPreamble preamble)
+{
+  return FullWifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)
+         + FullWifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)
+         + FullWifiPhy::GetPayloadDurationMicroSeconds (size, payloadMode);
+}
+
 Time
 FullWifiPhy::CalculateTxDuration (uint32_t size, FullWifiMode payloadMode, FullWifiPreamble preamble)
 {
-  uint32_t duration = GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)
-    + GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)
-    + GetPayloadDurationMicroSeconds (size, payloadMode);
-  return MicroSeconds (duration);
+  if (size < TX_DURATION_CACHE_SIZE)
+    {
+      uint32_t row = payloadMode.GetUid () * 2 + (preamble == FULL_WIFI_PREAMBLE_SHORT ? 1 : 0);
+      if (row >= g_txDurations.size ())
+        {
+          g_txDurations.resize (row + 1);
+        }
+      std::vector<uint32_t> &durations = g_txDurations[row];
+      if (durations.empty ())
+        {
+          durations.resize (TX_DURATION_CACHE_SIZE, 0);
+        }
+      uint32_t &duration = durations[size];
+      if (duration == 0)
+        {
+          duration = ComputeTxDurationMicroSeconds (size, payloadMode, preamble);
+        }
+      return MicroSeconds (duration);
+    }
+  return MicroSeconds (ComputeTxDurationMicroSeconds (size, payloadMode, preamble));
+}
+
+Time
+FullWifiPhy::CalculateTxDuration (uint32_t size, FullWifiMode payloadMode, FullWifiPreamble preamble,
+                                  const FullWifiTxMetadata &metadata)
+{
+  if (metadata.IsBusyTone ())
+    {
+      return metadata.duration;
+    }
+  return CalculateTxDuration (size, payloadMode, preamble);
 }
 
 
@@ -29,6 +29,8 @@
 #include "ns3/ptr.h"
 #include "full-wifi-mode.h"
 #include "full-wifi-preamble.h"
+#include "full-wifi-tx-metadata.h"
+#include "full-wifi-rx-frame.h"
 #include "full-wifi-phy-standard.h"
 #include "ns3/traced-callback.h"
 
@@ -48,6 +50,10 @@ public:
 
   /**
    * \param duration the expected duration of the packet reception.
+   * \param frame the frame being received, with its MAC header already
+   *        deserialized
+   * \param txMode the tx mode of the frame
+   * \param preamble the preamble of the frame
    *
    * We have received the first bit of a packet. We decided
    * that we could synchronize on this packet. It does not mean
@@ -58,7 +64,7 @@ public:
    *   - NotifyRxEndError
    *   - NotifyTxStart
    */
-  virtual void NotifyRxStart (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble) = 0;
+  virtual void NotifyRxStart (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble) = 0;
   /**
    * We have received the last bit of a packet for which
    * NotifyRxStart was invoked first and, the packet has
@@ -186,8 +192,11 @@ public:
    * \param preamble the type of preamble to use to send this packet.
    * \param txPowerLevel a power level to use to send this packet. The real
    *        transmission power is calculated as txPowerMin + txPowerLevel * (txPowerMax - txPowerMin) / nTxLevels
+   * \param metadata what the MAC knows about the frame (type, busy-tone
+   *        duration); the default describes a packet without MAC header
    */
-  virtual void SendPacket (Ptr<const Packet> packet, FullWifiMode mode, enum FullWifiPreamble preamble, uint8_t txPowerLevel) = 0;
+  virtual void SendPacket (Ptr<const Packet> packet, FullWifiMode mode, enum FullWifiPreamble preamble, uint8_t txPowerLevel,
+                           const FullWifiTxMetadata &metadata = FullWifiTxMetadata ()) = 0;
 
   /**
    * \param listener the new listener
@@ -248,8 +257,22 @@ public:
    * \param preamble the type of preamble to use for this packet.
    * \return the total amount of time this PHY will stay busy for
    *          the transmission of these bytes.
+   *
+   * The durations of frames shorter than 4096 bytes are memoized per mode
+   * and preamble: the ACK, CTS and RTS durations the MAC asks for on every
+   * exchange are computed once.
    */
   static Time CalculateTxDuration (uint32_t size, FullWifiMode payloadMode, enum FullWifiPreamble preamble);
+  /**
+   * \param size the number of bytes in the packet to send
+   * \param payloadMode the transmission mode to use for this packet
+   * \param preamble the type of preamble to use for this packet.
+   * \param metadata the metadata of the frame
+   * \return the time the frame occupies the medium: its Duration/ID
+   *          field for a busy tone, its transmission time otherwise.
+   */
+  static Time CalculateTxDuration (uint32_t size, FullWifiMode payloadMode, enum FullWifiPreamble preamble,
+                                   const FullWifiTxMetadata &metadata);
 
   /** 
    * \param payloadMode the FullWifiMode use for the transmission of the payload
@@ -0,0 +1,50 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "full-wifi-rx-frame.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+FullWifiRxFrame::FullWifiRxFrame (Ptr<const Packet> packet, const FullWifiTxMetadata &metadata)
+  : m_packet (packet),
+    m_hasHeader (metadata.hasMacHeader)
+{
+  if (m_hasHeader)
+    {
+      m_packet->PeekHeader (m_header);
+    }
+}
+
+Ptr<const Packet>
+FullWifiRxFrame::GetPacket (void) const
+{
+  return m_packet;
+}
+
+bool
+FullWifiRxFrame::HasHeader (void) const
+{
+  return m_hasHeader;
+}
+
+const FullWifiMacHeader &
+FullWifiRxFrame::GetHeader (void) const
+{
+  NS_ASSERT (m_hasHeader);
+  return m_header;
+}
+
+} // namespace ns3
@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FULL_WIFI_RX_FRAME_H
+#define FULL_WIFI_RX_FRAME_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/packet.h"
+#include "full-wifi-mac-header.h"
+#include "full-wifi-tx-metadata.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief a frame the PHY has synchronized on.
+ *
+ * The PHY builds it once when it starts receiving a frame and hands it to
+ * all its FullWifiPhyListener objects. The MAC header is deserialized
+ * here, once, so that none of the listeners has to peek it again.
+ */
+class FullWifiRxFrame : public SimpleRefCount<FullWifiRxFrame>
+{
+public:
+  /**
+   * \param packet the packet being received
+   * \param metadata the metadata the sender attached to the packet
+   */
+  FullWifiRxFrame (Ptr<const Packet> packet, const FullWifiTxMetadata &metadata);
+
+  /**
+   * \return the packet being received, MAC header included
+   */
+  Ptr<const Packet> GetPacket (void) const;
+  /**
+   * \return false if the packet was not sent by a MAC and has no header
+   */
+  bool HasHeader (void) const;
+  /**
+   * \return the MAC header of the packet
+   */
+  const FullWifiMacHeader & GetHeader (void) const;
+
+private:
+  Ptr<const Packet> m_packet;
+  FullWifiMacHeader m_header;
+  bool m_hasHeader;
+};
+
+} // namespace ns3
+
+#endif /* FULL_WIFI_RX_FRAME_H */
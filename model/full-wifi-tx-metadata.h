@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FULL_WIFI_TX_METADATA_H
+#define FULL_WIFI_TX_METADATA_H
+
+#include "ns3/nstime.h"
+#include "full-wifi-mac-header.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * What the PHY and the channel need to know about a frame beyond its
+ * mode and preamble. It is filled by FullMacLow from the header it has
+ * just built and travels with the packet down to the receivers, so that
+ * the MAC header never has to be deserialized below the MAC.
+ */
+struct FullWifiTxMetadata
+{
+  /// metadata of a packet which was not sent by a MAC
+  FullWifiTxMetadata ()
+    : type (FULL_WIFI_MAC_DATA),
+      duration (Seconds (0)),
+      hasMacHeader (false)
+  {
+  }
+  /**
+   * \param hdr the MAC header of the frame
+   */
+  FullWifiTxMetadata (const FullWifiMacHeader &hdr)
+    : type (hdr.GetType ()),
+      duration (hdr.GetDuration ()),
+      hasMacHeader (true)
+  {
+  }
+
+  /**
+   * \return true if the frame is a busy tone, which occupies the
+   *         medium for its Duration/ID field instead of its length
+   */
+  bool IsBusyTone (void) const
+  {
+    return hasMacHeader && type == FULL_WIFI_MAC_BUSY_TONE;
+  }
+
+  enum FullWifiMacType type;  //!< type of the MAC frame
+  Time duration;              //!< Duration/ID field of the MAC header
+  bool hasMacHeader;          //!< false for packets handed directly to the PHY
+};
+
+} // namespace ns3
+
+#endif /* FULL_WIFI_TX_METADATA_H */
@@ -41,7 +41,22 @@ FullYansErrorRateModel::GetTypeId (void)
 }
 
 FullYansErrorRateModel::FullYansErrorRateModel ()
+  : m_binomial (MAX_DISTANCE + 1)
 {
+  // Pascal's triangle, exact for the free distances of the 802.11 codes
+  for (uint32_t n = 0; n <= MAX_DISTANCE; n++)
+    {
+      m_binomial[n].resize (n + 1, 1.0);
+      for (uint32_t k = 1; k < n; k++)
+        {
+          m_binomial[n][k] = m_binomial[n - 1][k - 1] + m_binomial[n - 1][k];
+        }
+    }
+  PdCacheEntry invalid;
+  invalid.ber = 0;
+  invalid.pd = 0;
+  invalid.valid = false;
+  m_pdCache.assign (MAX_DISTANCE + 1, invalid);
 }
 
 double
@@ -69,21 +84,11 @@ FullYansErrorRateModel::GetQamBer (double snr, unsigned int m, uint32_t signalSp
   NS_LOG_INFO ("Qam m=" << m << " rate=" << phyRate << " snr=" << snr << " ber=" << ber);
   return ber;
 }
-uint32_t
-FullYansErrorRateModel::Factorial (uint32_t k) const
-{
-  uint32_t fact = 1;
-  while (k > 0)
-    {
-      fact *= k;
-      k--;
-    }
-  return fact;
-}
 double
 FullYansErrorRateModel::Binomial (uint32_t k, double p, uint32_t n) const
 {
-  double retval = Factorial (n) / (Factorial (k) * Factorial (n - k)) * std::pow (p, static_cast<double> (k)) * std::pow (1 - p, static_cast<double> (n - k));
+  NS_ASSERT (n <= MAX_DISTANCE && k <= n);
+  double retval = m_binomial[n][k] * std::pow (p, static_cast<double> (k)) * std::pow (1 - p, static_cast<double> (n - k));
   return retval;
 }
 double
@@ -120,6 +125,14 @@ FullYansErrorRateModel::CalculatePdEven (double ber, unsigned int d) const
 double
 FullYansErrorRateModel::CalculatePd (double ber, unsigned int d) const
 {
+  NS_ASSERT (d <= MAX_DISTANCE);
+  // the chunks of a frame which see the same interference keep asking
+  // for the same ber
+  PdCacheEntry &entry = m_pdCache[d];
+  if (entry.valid && entry.ber == ber)
+    {
+      return entry.pd;
+    }
   double pd;
   if ((d % 2) == 0)
     {
@@ -129,37 +142,81 @@ FullYansErrorRateModel::CalculatePd (double ber, unsigned int d) const
     {
       pd = CalculatePdOdd (ber, d);
     }
+  entry.ber = ber;
+  entry.pd = pd;
+  entry.valid = true;
   return pd;
 }
 
 double
-FullYansErrorRateModel::GetFecBpskBer (double snr, double nbits,
-                                   uint32_t signalSpread, uint32_t phyRate,
-                                   uint32_t dFree, uint32_t adFree) const
+FullYansErrorRateModel::DoGetCodedBitErrorRate (FullWifiMode mode, double snr) const
 {
-  double ber = GetBpskBer (snr, signalSpread, phyRate);
-  if (ber == 0.0)
+  if (mode.GetModulationClass () != FULL_WIFI_MOD_CLASS_ERP_OFDM
+      && mode.GetModulationClass () != FULL_WIFI_MOD_CLASS_OFDM)
     {
-      return 1.0;
+      return -1.0;
     }
-  double pd = CalculatePd (ber, dFree);
-  double pmu = adFree * pd;
-  pmu = std::min (pmu, 1.0);
-  double pms = std::pow (1 - pmu, nbits);
-  return pms;
-}
-
-double
-FullYansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
-                                  uint32_t signalSpread,
-                                  uint32_t phyRate,
-                                  uint32_t m, uint32_t dFree,
-                                  uint32_t adFree, uint32_t adFreePlusOne) const
-{
-  double ber = GetQamBer (snr, m, signalSpread, phyRate);
+  uint32_t m = mode.GetConstellationSize ();
+  uint32_t dFree;
+  uint32_t adFree;
+  uint32_t adFreePlusOne;
+  if (m == 2)
+    {
+      if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
+        {
+          dFree = 10;
+          adFree = 11;
+        }
+      else
+        {
+          dFree = 5;
+          adFree = 8;
+        }
+      double ber = GetBpskBer (snr, mode.GetBandwidth (), mode.GetPhyRate ());
+      if (ber == 0.0)
+        {
+          return 0.0;
+        }
+      return adFree * CalculatePd (ber, dFree);
+    }
+  else if (m == 4 || m == 16)
+    {
+      if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
+        {
+          dFree = 10;
+          adFree = 11;
+          adFreePlusOne = 0;
+        }
+      else
+        {
+          dFree = 5;
+          adFree = 8;
+          adFreePlusOne = 31;
+        }
+    }
+  else if (m == 64)
+    {
+      if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_2_3)
+        {
+          dFree = 6;
+          adFree = 1;
+          adFreePlusOne = 16;
+        }
+      else
+        {
+          dFree = 5;
+          adFree = 8;
+          adFreePlusOne = 31;
+        }
+    }
+  else
+    {
+      return -1.0;
+    }
+  double ber = GetQamBer (snr, m, mode.GetBandwidth (), mode.GetPhyRate ());
   if (ber == 0.0)
     {
-      return 1.0;
+      return 0.0;
     }
   /* first term */
   double pd = CalculatePd (ber, dFree);
@@ -167,9 +224,7 @@ FullYansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
   /* second term */
   pd = CalculatePd (ber, dFree + 1);
   pmu += adFreePlusOne * pd;
-  pmu = std::min (pmu, 1.0);
-  double pms = std::pow (1 - pmu, static_cast<double> (nbits));
-  return pms;
+  return pmu;
 }
 
 double
@@ -178,110 +233,7 @@ FullYansErrorRateModel::GetChunkSuccessRate (FullWifiMode mode, double snr, uint
   if (mode.GetModulationClass () == FULL_WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == FULL_WIFI_MOD_CLASS_OFDM)
     {
-      if (mode.GetConstellationSize () == 2)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    mode.GetBandwidth (), // signal spread
-                                    mode.GetPhyRate (), // phy rate
-                                    10, // dFree
-                                    11 // adFree
-                                    );
-            }
-          else
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    mode.GetBandwidth (), // signal spread
-                                    mode.GetPhyRate (), // phy rate
-                                    5, // dFree
-                                    8 // adFree
-                                    );
-            }
-        }
-      else if (mode.GetConstellationSize () == 4)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   4,  // m
-                                   10, // dFree
-                                   11, // adFree
-                                   0   // adFreePlusOne
-                                   );
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   4, // m
-                                   5, // dFree
-                                   8, // adFree
-                                   31 // adFreePlusOne
-                                   );
-            }
-        }
-      else if (mode.GetConstellationSize () == 16)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   16, // m
-                                   10, // dFree
-                                   11, // adFree
-                                   0   // adFreePlusOne
-                                   );
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   16, // m
-                                   5,  // dFree
-                                   8,  // adFree
-                                   31  // adFreePlusOne
-                                   );
-            }
-        }
-      else if (mode.GetConstellationSize () == 64)
-        {
-          if (mode.GetCodeRate () == FULL_WIFI_CODE_RATE_2_3)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   64, // m
-                                   6,  // dFree
-                                   1,  // adFree
-                                   16  // adFreePlusOne
-                                   );
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   mode.GetBandwidth (), // signal spread
-                                   mode.GetPhyRate (), // phy rate
-                                   64, // m
-                                   5,  // dFree
-                                   8,  // adFree
-                                   31  // adFreePlusOne
-                                   );
-            }
-        }
+      return GetCodedChunkSuccessRate (mode, snr, nbits);
     }
   else if (mode.GetModulationClass () == FULL_WIFI_MOD_CLASS_DSSS)
     {
@@ -21,6 +21,7 @@
 #define FULL_YANS_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <vector>
 #include "full-wifi-mode.h"
 #include "full-error-rate-model.h"
 #include "full-dsss-error-rate-model.h"
@@ -65,19 +66,35 @@ private:
   double Log2 (double val) const;
   double GetBpskBer (double snr, uint32_t signalSpread, uint32_t phyRate) const;
   double GetQamBer (double snr, unsigned int m, uint32_t signalSpread, uint32_t phyRate) const;
-  uint32_t Factorial (uint32_t k) const;
   double Binomial (uint32_t k, double p, uint32_t n) const;
   double CalculatePdOdd (double ber, unsigned int d) const;
   double CalculatePdEven (double ber, unsigned int d) const;
   double CalculatePd (double ber, unsigned int d) const;
-  double GetFecBpskBer (double snr, double nbits,
-                        uint32_t signalSpread, uint32_t phyRate,
-                        uint32_t dFree, uint32_t adFree) const;
-  double GetFecQamBer (double snr, uint32_t nbits,
-                       uint32_t signalSpread,
-                       uint32_t phyRate,
-                       uint32_t m, uint32_t dfree,
-                       uint32_t adFree, uint32_t adFreePlusOne) const;
+  /**
+   * \param mode a coded OFDM mode
+   * \param snr the snr (linear)
+   * \returns the union bound on the bit error rate after decoding, or a
+   *          negative value for the other modes
+   */
+  virtual double DoGetCodedBitErrorRate (FullWifiMode mode, double snr) const;
+
+  /// largest free distance handled by the binomial table
+  static const uint32_t MAX_DISTANCE = 16;
+
+  /**
+   * Last pairwise error probability computed for a free distance.
+   */
+  struct PdCacheEntry
+  {
+    double ber;
+    double pd;
+    bool valid;
+  };
+
+  /// binomial coefficients, m_binomial[n][k] is n choose k
+  std::vector<std::vector<double> > m_binomial;
+  /// last CalculatePd result, indexed by free distance
+  mutable std::vector<PdCacheEntry> m_pdCache;
 };
 
 
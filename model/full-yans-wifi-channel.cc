@@ -20,15 +20,21 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/nstime.h"
 #include "ns3/object-factory.h"
 #include "full-yans-wifi-channel.h"
 #include "full-yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include <algorithm>
+#include <cmath>
 
 NS_LOG_COMPONENT_DEFINE ("FullYansWifiChannel");
 
@@ -50,11 +56,60 @@ FullYansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&FullYansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("EnableReceiverCulling",
+                   "Do not deliver a transmission to receivers beyond CullingRange "
+                   "or whose received power is below CullingThreshold.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FullYansWifiChannel::m_enableCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingThreshold",
+                   "Received power (dbm) below which a signal is considered negligible. "
+                   "Should stay well below the CcaMode1Threshold and noise floor of the receivers.",
+                   DoubleValue (-110.0),
+                   MakeDoubleAccessor (&FullYansWifiChannel::m_cullingThresholdDbm),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("CullingRange",
+                   "Distance (m) beyond which receivers are never considered. "
+                   "Must be chosen so that the loss model cannot yield a signal above "
+                   "CullingThreshold farther away. 0 disables the spatial index.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&FullYansWifiChannel::m_cullingRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("SpatialIndexCellSize",
+                   "Side (m) of a cell of the grid used to look up receivers within CullingRange.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&FullYansWifiChannel::m_cellSize),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("CacheLinkBudgets",
+                   "Compute the rx power and delay of each sender/receiver pair once and reuse "
+                   "them until a mobility model reports a course change. "
+                   "Only valid with deterministic propagation loss models. "
+                   "Ignored unless every PHY has a ConstantPositionMobilityModel.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FullYansWifiChannel::m_cacheLinks),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EnableFarFieldAggregation",
+                   "Do not deliver transmissions arriving below FarFieldThreshold: "
+                   "add their power to the background interference level of the receiver instead.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FullYansWifiChannel::m_farField),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FarFieldThreshold",
+                   "Received power (dbm) below which a transmission only contributes to the "
+                   "aggregate interference. Lower values are more accurate and slower. "
+                   "Should stay below the CcaMode1Threshold of the receivers.",
+                   DoubleValue (-100.0),
+                   MakeDoubleAccessor (&FullYansWifiChannel::m_farFieldThresholdDbm),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 FullYansWifiChannel::FullYansWifiChannel ()
+  : m_gridValid (false),
+    m_nTracked (0),
+    m_staticMobility (true),
+    m_linksValid (false)
 {
 }
 FullYansWifiChannel::~FullYansWifiChannel ()
@@ -76,49 +131,214 @@ FullYansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
 
 void
 FullYansWifiChannel::Send (Ptr<FullYansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
-                       FullWifiMode wifiMode, FullWifiPreamble preamble) const
+                       FullWifiMode wifiMode, FullWifiPreamble preamble,
+                       const FullWifiTxMetadata &metadata) const
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  bool useRange = m_enableCulling && m_cullingRange > 0;
+  if (useRange || m_cacheLinks)
     {
-      if (sender != (*i))
+      TrackMobility ();
+    }
+  // models which move without a course change would leave the grid and
+  // the link budgets stale: only static topologies use them
+  bool useGrid = useRange && m_staticMobility;
+  uint32_t senderIndex = sender->GetChannelIndex ();
+  NS_ASSERT (senderIndex < m_phyList.size () && m_phyList[senderIndex] == sender);
+  // the sender may still modify its packet, so receivers get one shared copy
+  Ptr<const Packet> shared = packet->Copy ();
+  // For now don't account for inter channel interference: only the
+  // receivers operating on the channel number of the sender are visited.
+  std::vector<uint32_t> candidates;
+  FarFieldContributions farField;
+  const std::vector<uint32_t> *receivers;
+  if (useGrid)
+    {
+      UpdateGrid ();
+      GetCandidates (senderMobility->GetPosition (), candidates);
+      receivers = &candidates;
+    }
+  else
+    {
+      ChannelPhys::const_iterator bucket = m_channelPhys.find (sender->GetChannelNumber ());
+      NS_ASSERT (bucket != m_channelPhys.end ());
+      receivers = &bucket->second;
+    }
+  for (std::vector<uint32_t>::const_iterator k = receivers->begin (); k != receivers->end (); k++)
+    {
+      uint32_t j = *k;
+      Ptr<FullYansWifiPhy> receiver = m_phyList[j];
+      if (sender != receiver)
         {
-          // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (useGrid && receiver->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
+          Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+          if (useRange && senderMobility->GetDistanceFrom (receiverMobility) > m_cullingRange)
+            {
+              continue;
+            }
+          double rxPowerDbm;
+          Time delay;
+          GetLinkBudget (senderIndex, j, senderMobility, receiverMobility, txPowerDbm, rxPowerDbm, delay);
+          if (m_enableCulling && rxPowerDbm < m_cullingThresholdDbm)
             {
-              dstNode = 0xffffffff;
+              NS_LOG_DEBUG ("culled receiver " << j << ": rxPower=" << rxPowerDbm << "dbm");
+              continue;
             }
-          else
+          if (m_farField && rxPowerDbm < m_farFieldThresholdDbm)
             {
-              dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+              farField.push_back (std::make_pair (j, rxPowerDbm));
+              receiver->AddFarFieldInterference (rxPowerDbm);
+              continue;
             }
-          Simulator::ScheduleWithContext (dstNode,
+          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+          Simulator::ScheduleWithContext (GetNodeContext (j),
                                           delay, &FullYansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, wifiMode, preamble);
+                                          j, shared, rxPowerDbm, wifiMode, preamble, metadata);
+        }
+    }
+  if (!farField.empty ())
+    {
+      NS_LOG_DEBUG ("aggregated " << farField.size () << " far-field receivers");
+      Time duration = FullWifiPhy::CalculateTxDuration (packet->GetSize (), wifiMode, preamble, metadata);
+      Simulator::Schedule (duration,
+                           &FullYansWifiChannel::EndFarField, this, farField);
+    }
+}
+
+void
+FullYansWifiChannel::EndFarField (FarFieldContributions contributions) const
+{
+  for (FarFieldContributions::const_iterator i = contributions.begin (); i != contributions.end (); i++)
+    {
+      m_phyList[i->first]->RemoveFarFieldInterference (i->second);
+    }
+}
+
+FullYansWifiChannel::GridCell
+FullYansWifiChannel::GetGridCell (const Vector &position) const
+{
+  return GridCell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+                   static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+FullYansWifiChannel::TrackMobility (void) const
+{
+  for (; m_nTracked < m_phyList.size (); m_nTracked++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[m_nTracked]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      if (DynamicCast<ConstantPositionMobilityModel> (mobility) == 0)
+        {
+          m_staticMobility = false;
+        }
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&FullYansWifiChannel::NotifyCourseChange, this));
+      m_gridValid = false;
+      m_linksValid = false;
+    }
+}
+
+void
+FullYansWifiChannel::UpdateGrid (void) const
+{
+  if (m_gridValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_grid.clear ();
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+      m_grid[GetGridCell (mobility->GetPosition ())].push_back (j);
+    }
+  m_gridValid = true;
+}
+
+void
+FullYansWifiChannel::GetCandidates (const Vector &position, std::vector<uint32_t> &candidates) const
+{
+  GridCell center = GetGridCell (position);
+  int64_t reach = static_cast<int64_t> (std::ceil (m_cullingRange / m_cellSize));
+  for (int64_t x = center.first - reach; x <= center.first + reach; x++)
+    {
+      for (int64_t y = center.second - reach; y <= center.second + reach; y++)
+        {
+          Grid::const_iterator cell = m_grid.find (GridCell (x, y));
+          if (cell != m_grid.end ())
+            {
+              candidates.insert (candidates.end (), cell->second.begin (), cell->second.end ());
+            }
         }
     }
+  // keep the scheduling order of the full scan so that results do not
+  // depend on the layout of the grid
+  std::sort (candidates.begin (), candidates.end ());
 }
 
 void
-FullYansWifiChannel::Receive (std::size_t i, Ptr<Packet> packet, double rxPowerDbm,
-                          FullWifiMode txMode, FullWifiPreamble preamble) const
+FullYansWifiChannel::GetLinkBudget (uint32_t from, uint32_t to,
+                                    Ptr<MobilityModel> senderMobility, Ptr<MobilityModel> receiverMobility,
+                                    double txPowerDbm, double &rxPowerDbm, Time &delay) const
 {
-  m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txMode, preamble);
+  if (!m_cacheLinks || !m_staticMobility)
+    {
+      rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      return;
+    }
+  uint32_t n = m_phyList.size ();
+  if (!m_linksValid || m_links.size () != n * n)
+    {
+      NS_LOG_DEBUG ("reset link budget cache for " << n << " phys");
+      LinkBudget invalid;
+      invalid.lossDb = 0;
+      invalid.valid = false;
+      m_links.assign (n * n, invalid);
+      m_linksValid = true;
+    }
+  LinkBudget &link = m_links[from * n + to];
+  if (!link.valid)
+    {
+      link.lossDb = txPowerDbm - m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      link.delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      link.valid = true;
+    }
+  rxPowerDbm = txPowerDbm - link.lossDb;
+  delay = link.delay;
+}
+
+void
+FullYansWifiChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility) const
+{
+  m_gridValid = false;
+  m_linksValid = false;
+}
+
+uint32_t
+FullYansWifiChannel::GetNodeContext (uint32_t i) const
+{
+  Ptr<Object> dstNetDevice = m_phyList[i]->GetDevice ();
+  if (dstNetDevice == 0)
+    {
+      return 0xffffffff;
+    }
+  return dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+}
+
+void
+FullYansWifiChannel::Receive (std::size_t i, Ptr<const Packet> packet, double rxPowerDbm,
+                          FullWifiMode txMode, FullWifiPreamble preamble,
+                          FullWifiTxMetadata metadata) const
+{
+  m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txMode, preamble, metadata);
 }
 
 std::size_t FullYansWifiChannel::GetNDevices (void) const
@@ -131,10 +351,31 @@ FullYansWifiChannel::GetDevice (std::size_t i) const
   return m_phyList[i]->GetDevice ()->GetObject<NetDevice> ();
 }
 
-void
+uint32_t
 FullYansWifiChannel::Add (Ptr<FullYansWifiPhy> phy)
 {
+  uint32_t index = m_phyList.size ();
+  m_channelPhys[phy->GetChannelNumber ()].push_back (index);
   m_phyList.push_back (phy);
+  return index;
+}
+
+void
+FullYansWifiChannel::NotifyChannelNumberChange (Ptr<FullYansWifiPhy> phy, uint16_t from, uint16_t to)
+{
+  NS_LOG_FUNCTION (this << phy << from << to);
+  if (from == to)
+    {
+      return;
+    }
+  uint32_t index = phy->GetChannelIndex ();
+  NS_ASSERT (index < m_phyList.size () && m_phyList[index] == phy);
+  std::vector<uint32_t> &oldBucket = m_channelPhys[from];
+  std::vector<uint32_t>::iterator it = std::lower_bound (oldBucket.begin (), oldBucket.end (), index);
+  NS_ASSERT (it != oldBucket.end () && *it == index);
+  oldBucket.erase (it);
+  std::vector<uint32_t> &newBucket = m_channelPhys[to];
+  newBucket.insert (std::lower_bound (newBucket.begin (), newBucket.end (), index), index);
 }
 
 int64_t
@@ -21,17 +21,22 @@
 #define FULL_YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
+#include "ns3/vector.h"
+#include "ns3/nstime.h"
 #include "full-wifi-channel.h"
 #include "full-wifi-mode.h"
 #include "full-wifi-preamble.h"
+#include "full-wifi-tx-metadata.h"
 
 namespace ns3 {
 
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class MobilityModel;
 class FullYansWifiPhy;
 
 /**
@@ -45,6 +50,35 @@ class FullYansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * When the EnableReceiverCulling attribute is set, receivers which cannot
+ * be affected by a transmission are not scheduled at all: PHYs farther away
+ * than CullingRange are skipped through a uniform grid built over the
+ * positions of the attached mobility models, and PHYs whose received power
+ * falls below CullingThreshold never get a packet copy or a receive event.
+ * The grid is rebuilt lazily whenever one of the mobility models reports a
+ * course change. Models such as ConstantVelocityMobilityModel move without
+ * reporting one, so the grid is only used while every attached PHY has a
+ * ConstantPositionMobilityModel; otherwise all the receivers are scanned
+ * and CullingRange is checked against their current position.
+ *
+ * For static topologies, the CacheLinkBudgets attribute makes the channel
+ * remember the path loss and propagation delay of every sender/receiver
+ * pair the first time it is used, so that the propagation models are only
+ * queried again after a course change. This assumes a deterministic loss
+ * model: random fading models would be sampled once per link. Like the
+ * grid, the cache is only used while every attached PHY has a
+ * ConstantPositionMobilityModel, since other models may move without a
+ * course change.
+ *
+ * EnableFarFieldAggregation trades accuracy for speed in very large
+ * networks: receivers at which a transmission arrives below
+ * FarFieldThreshold do not receive it, its power is only added to their
+ * background interference level for the duration of the transmission
+ * (see FullYansWifiPhy::AddFarFieldInterference). The propagation delay
+ * of these contributions is ignored and a receiver accounts for their
+ * mean power over each reception. Lowering the threshold makes the
+ * approximation more accurate.
  */
 class FullYansWifiChannel : public FullWifiChannel
 {
@@ -58,7 +92,21 @@ public:
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
-  void Add (Ptr<FullYansWifiPhy> phy);
+  /**
+   * \param phy the PHY to attach to this channel
+   * \return the index of the PHY in the channel, see
+   *         FullYansWifiPhy::GetChannelIndex
+   */
+  uint32_t Add (Ptr<FullYansWifiPhy> phy);
+  /**
+   * \param phy a PHY attached to this channel
+   * \param from the channel number the PHY was operating on
+   * \param to the channel number the PHY is switching to
+   *
+   * Move the PHY to the receiver list of its new channel number. Invoked
+   * by FullYansWifiPhy::SetChannelNumber.
+   */
+  void NotifyChannelNumberChange (Ptr<FullYansWifiPhy> phy, uint16_t from, uint16_t to);
 
   /**
    * \param loss the new propagation loss model.
@@ -75,14 +123,19 @@ public:
    * \param txPowerDbm the tx power associated to the packet
    * \param wifiMode the tx mode associated to the packet
    * \param preamble the preamble associated to the packet
+   * \param metadata the metadata of the frame, handed to the receivers
    *
    * This method should not be invoked by normal users. It is
    * currently invoked only from WifiPhy::Send. YansWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
    * e.g. PHYs that are operating on the same channel.
+   *
+   * All receivers share a single read-only copy of the packet; a
+   * receiver makes its own copy only when it passes the frame up.
    */
   void Send (Ptr<FullYansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
-             FullWifiMode wifiMode, FullWifiPreamble preamble) const;
+             FullWifiMode wifiMode, FullWifiPreamble preamble,
+             const FullWifiTxMetadata &metadata) const;
 
  /**
   * Assign a fixed random variable stream number to the random variables
@@ -99,13 +152,96 @@ private:
   FullYansWifiChannel (const FullYansWifiChannel &);
 
   typedef std::vector<Ptr<FullYansWifiPhy> > PhyList;
-  void Receive (std::size_t i, Ptr<Packet> packet, double rxPowerDbm,
-                FullWifiMode txMode, FullWifiPreamble preamble) const;
+  typedef std::pair<int64_t, int64_t> GridCell;
+  typedef std::map<GridCell, std::vector<uint32_t> > Grid;
+
+  /**
+   * Cached propagation between two PHYs of m_phyList.
+   */
+  struct LinkBudget
+  {
+    double lossDb;  //!< tx power minus rx power
+    Time delay;     //!< propagation delay
+    bool valid;     //!< false until computed
+  };
+  typedef std::vector<LinkBudget> LinkBudgets;
+  typedef std::map<uint16_t, std::vector<uint32_t> > ChannelPhys;
+
+  /// far-field contributions of a transmission: PHY index, rx power (dBm)
+  typedef std::vector<std::pair<uint32_t, double> > FarFieldContributions;
+
+  /**
+   * \param contributions the far-field contributions of a transmission
+   *        which ends now
+   */
+  void EndFarField (FarFieldContributions contributions) const;
 
+  void Receive (std::size_t i, Ptr<const Packet> packet, double rxPowerDbm,
+                FullWifiMode txMode, FullWifiPreamble preamble,
+                FullWifiTxMetadata metadata) const;
+  /**
+   * \param i the index of a PHY in m_phyList
+   * \return the id of the node of the PHY, to be used as event context
+   */
+  uint32_t GetNodeContext (uint32_t i) const;
+
+  /**
+   * \param position a position in space
+   * \return the grid cell holding this position
+   */
+  GridCell GetGridCell (const Vector &position) const;
+  /**
+   * Hook the CourseChange trace of the PHYs added since the last call.
+   */
+  void TrackMobility (void) const;
+  /**
+   * Rebuild the receiver grid if a mobility model moved since the
+   * last build.
+   */
+  void UpdateGrid (void) const;
+  /**
+   * \param from the index of the sender in m_phyList
+   * \param to the index of the receiver in m_phyList
+   * \param senderMobility the mobility model of the sender
+   * \param receiverMobility the mobility model of the receiver
+   * \param txPowerDbm the tx power of the transmission
+   * \param rxPowerDbm set to the rx power at the receiver
+   * \param delay set to the propagation delay
+   *
+   * Query the propagation models, or the link budget cache if it is
+   * enabled and every mobility model is static.
+   */
+  void GetLinkBudget (uint32_t from, uint32_t to,
+                      Ptr<MobilityModel> senderMobility, Ptr<MobilityModel> receiverMobility,
+                      double txPowerDbm, double &rxPowerDbm, Time &delay) const;
+  /**
+   * \param position the position of the sender
+   * \param candidates filled with the sorted indices of the PHYs whose
+   *        grid cell lies within CullingRange of the sender
+   */
+  void GetCandidates (const Vector &position, std::vector<uint32_t> &candidates) const;
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility) const;
 
   PhyList m_phyList;
+  ChannelPhys m_channelPhys;       //!< sorted PHY indices per channel number
   Ptr<PropagationLossModel> m_loss;
   Ptr<PropagationDelayModel> m_delay;
+
+  bool m_enableCulling;            //!< skip receivers which cannot be affected
+  double m_cullingThresholdDbm;    //!< rx power (dBm) below which a receiver is skipped
+  double m_cullingRange;           //!< distance (m) beyond which a receiver is skipped, 0 to disable
+  double m_cellSize;               //!< side (m) of a grid cell
+  mutable Grid m_grid;             //!< PHY indices bucketed by grid cell
+  mutable bool m_gridValid;        //!< false once a mobility model moved
+  mutable uint32_t m_nTracked;     //!< number of PHYs whose CourseChange is hooked
+  mutable bool m_staticMobility;   //!< true while all the tracked models are ConstantPosition
+
+  bool m_cacheLinks;               //!< reuse the link budget of every pair
+  mutable LinkBudgets m_links;     //!< row-major matrix indexed by sender, receiver
+  mutable bool m_linksValid;       //!< false once a mobility model moved
+
+  bool m_farField;                 //!< aggregate the weak arrivals as background interference
+  double m_farFieldThresholdDbm;   //!< rx power (dBm) below which an arrival is far-field
 };
 
 } // namespace ns3
@@ -19,7 +19,6 @@
  */
 
 #include "full-yans-wifi-phy.h"
-#include "full-wifi-mac-header.h"
 #include "full-yans-wifi-channel.h"
 #include "full-wifi-mode.h"
 #include "full-wifi-preamble.h"
@@ -37,6 +36,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/boolean.h"
 #include <cmath>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("FullYansWifiPhy");
 
@@ -64,6 +64,14 @@ FullYansWifiPhy::GetTypeId (void)
                    MakeDoubleAccessor (&FullYansWifiPhy::SetCcaMode1Threshold,
                                        &FullYansWifiPhy::GetCcaMode1Threshold),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("InterferenceFloor",
+                   "Incoming signals whose power (dbm) is below this threshold are ignored: they "
+                   "are neither received nor tracked as interference. Should stay well below the "
+                   "noise floor and CcaMode1Threshold. The default value disables this.",
+                   DoubleValue (-1000.0),
+                   MakeDoubleAccessor (&FullYansWifiPhy::SetInterferenceFloor,
+                                       &FullYansWifiPhy::GetInterferenceFloor),
+                   MakeDoubleChecker<double> ())
     .AddAttribute ("TxGain",
                    "Transmission gain (dB).",
                    DoubleValue (1.0),
@@ -137,15 +145,22 @@ FullYansWifiPhy::GetTypeId (void)
                    MakeUintegerAccessor (&FullYansWifiPhy::SetChannelNumber,
                                          &FullYansWifiPhy::GetChannelNumber),
                    MakeUintegerChecker<uint16_t> ())
+    .AddTraceSource ("NegligibleArrivals",
+                     "Number of incoming signals ignored because they were below the InterferenceFloor",
+                     MakeTraceSourceAccessor (&FullYansWifiPhy::m_negligibleArrivals))
 
   ;
   return tid;
 }
 
 FullYansWifiPhy::FullYansWifiPhy ()
-  :  m_channelNumber (1),
+  :  m_channelIndex (0),
+    m_channelNumber (1),
     m_endRxEvent (),
-    m_channelStartingFrequency (0)
+    m_channelStartingFrequency (0),
+    m_negligibleArrivals (0),
+    m_farFieldW (0.0),
+    m_nFarField (0)
 {
   NS_LOG_FUNCTION (this);
   m_random = CreateObject<UniformRandomVariable> ();
@@ -256,6 +271,12 @@ FullYansWifiPhy::SetCcaMode1Threshold (double threshold)
   m_ccaMode1ThresholdW = DbmToW (threshold);
 }
 void
+FullYansWifiPhy::SetInterferenceFloor (double threshold)
+{
+  NS_LOG_FUNCTION (this << threshold);
+  m_interferenceFloorW = DbmToW (threshold);
+}
+void
 FullYansWifiPhy::SetErrorRateModel (Ptr<FullErrorRateModel> rate)
 {
   m_interference.SetErrorRateModel (rate);
@@ -331,6 +352,12 @@ FullYansWifiPhy::GetCcaMode1Threshold (void) const
   return WToDbm (m_ccaMode1ThresholdW);
 }
 
+double
+FullYansWifiPhy::GetInterferenceFloor (void) const
+{
+  return WToDbm (m_interferenceFloorW);
+}
+
 Ptr<FullErrorRateModel>
 FullYansWifiPhy::GetErrorRateModel (void) const
 {
@@ -362,7 +389,7 @@ void
 FullYansWifiPhy::SetChannel (Ptr<FullYansWifiChannel> channel)
 {
   m_channel = channel;
-  m_channel->Add (this);
+  m_channelIndex = m_channel->Add (this);
 }
 
 void
@@ -372,6 +399,10 @@ FullYansWifiPhy::SetChannelNumber (uint16_t nch)
     {
       // this is not channel switch, this is initialization
       NS_LOG_DEBUG ("start at channel " << nch);
+      if (m_channel != 0)
+        {
+          m_channel->NotifyChannelNumberChange (this, m_channelNumber, nch);
+        }
       m_channelNumber = nch;
       return;
     }
@@ -420,6 +451,10 @@ switchChannel:
    * state are added to the event list and are employed later to figure
    * out the state of the medium after the switching.
    */
+  if (m_channel != 0)
+    {
+      m_channel->NotifyChannelNumberChange (this, m_channelNumber, nch);
+    }
   m_channelNumber = nch;
 }
 
@@ -429,6 +464,12 @@ FullYansWifiPhy::GetChannelNumber () const
   return m_channelNumber;
 }
 
+uint32_t
+FullYansWifiPhy::GetChannelIndex (void) const
+{
+  return m_channelIndex;
+}
+
 double
 FullYansWifiPhy::GetChannelFrequencyMhz () const
 {
@@ -446,21 +487,44 @@ FullYansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
   m_receiveState->SetReceiveErrorCallback (callback);
 }
 void
-FullYansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+FullYansWifiPhy::AddFarFieldInterference (double rxPowerDbm)
+{
+  NS_LOG_FUNCTION (this << rxPowerDbm);
+  m_farFieldW += DbmToW (rxPowerDbm + m_rxGainDb);
+  m_nFarField++;
+  m_interference.SetBackgroundPower (m_farFieldW);
+}
+
+void
+FullYansWifiPhy::RemoveFarFieldInterference (double rxPowerDbm)
+{
+  NS_LOG_FUNCTION (this << rxPowerDbm);
+  NS_ASSERT (m_nFarField > 0);
+  m_nFarField--;
+  // clear the rounding errors once no far-field transmission is left
+  m_farFieldW = m_nFarField == 0 ? 0.0 : std::max (m_farFieldW - DbmToW (rxPowerDbm + m_rxGainDb), 0.0);
+  m_interference.SetBackgroundPower (m_farFieldW);
+}
+
+void
+FullYansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  double rxPowerDbm,
                                  FullWifiMode txMode,
-                                 enum FullWifiPreamble preamble)
+                                 enum FullWifiPreamble preamble,
+                                 const FullWifiTxMetadata &metadata)
 {
 //  NS_LOG_FUNCTION (this << packet << rxPowerDbm << txMode << preamble);
   rxPowerDbm += m_rxGainDb;
   double rxPowerW = DbmToW (rxPowerDbm);
-  Time rxDuration = CalculateTxDuration (packet->GetSize (), txMode, preamble);
-  FullWifiMacHeader header;
-  packet->PeekHeader (header);
-  if (header.GetType () == FULL_WIFI_MAC_BUSY_TONE)
+  if (rxPowerW < m_interferenceFloorW)
     {
-      rxDuration = header.GetDuration ();
+      // too weak to matter: keep it out of the interference bookkeeping
+      NS_LOG_DEBUG ("ignore signal below the interference floor (power=" << rxPowerW << "W)");
+      m_negligibleArrivals++;
+      NotifyRxDrop (packet);
+      return;
     }
+  Time rxDuration = CalculateTxDuration (packet->GetSize (), txMode, preamble, metadata);
   Time endRx = Simulator::Now () + rxDuration;
   double capRxW = DbmToW (rxPowerDbm - m_captureEffectThreshold);
   double noiseInterferenceW;
@@ -553,7 +617,8 @@ FullYansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
         {
           NS_LOG_DEBUG ("sync to signal (power=" << rxPowerW << "W)");
           // sync to signal
-          m_receiveState->SwitchToRx (rxDuration, packet, txMode, preamble);
+          // the MAC header is parsed here once for all the listeners
+          m_receiveState->SwitchToRx (rxDuration, Create<FullWifiRxFrame> (packet, metadata), txMode, preamble);
           NS_ASSERT (m_endRxEvent.IsExpired ());
           NotifyRxBegin (packet);
           m_interference.NotifyRxStart ();
@@ -596,7 +661,8 @@ maybeCcaBusy:
 }
 
 void
-FullYansWifiPhy::SendPacket (Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble, uint8_t txPower)
+FullYansWifiPhy::SendPacket (Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble, uint8_t txPower,
+                             const FullWifiTxMetadata &metadata)
 {
   NS_LOG_FUNCTION (this << packet << txMode << preamble << (uint32_t)txPower);
   /* Transmission can happen if:
@@ -618,13 +684,7 @@ FullYansWifiPhy::SendPacket (Ptr<const Packet> packet, FullWifiMode txMode, Full
   
   NS_ASSERT (!m_sendState->IsStateTx () && !m_sendState->IsStateSwitching ());
 
-  Time txDuration = CalculateTxDuration (packet->GetSize (), txMode, preamble);
-  FullWifiMacHeader header;
-  packet->PeekHeader (header);
-  if (header.GetType () == FULL_WIFI_MAC_BUSY_TONE)
-    {
-      txDuration = header.GetDuration ();
-    }
+  Time txDuration = CalculateTxDuration (packet->GetSize (), txMode, preamble, metadata);
 //  if (m_receiveState->IsStateRx ())
 //    {
 //      m_endRxEvent.Cancel ();
@@ -635,7 +695,7 @@ FullYansWifiPhy::SendPacket (Ptr<const Packet> packet, FullWifiMode txMode, Full
   bool isShortPreamble = (FULL_WIFI_PREAMBLE_SHORT == preamble);
   NotifyMonitorSniffTx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble);
   m_sendState->SwitchToTx (txDuration, packet, txMode, preamble, txPower);
-  m_channel->Send (this, packet, GetPowerDbm (txPower) + m_txGainDb, txMode, preamble);
+  m_channel->Send (this, packet, GetPowerDbm (txPower) + m_txGainDb, txMode, preamble, metadata);
 }
 
 uint32_t
@@ -906,7 +966,7 @@ FullYansWifiPhy::GetPowerDbm (uint8_t power) const
 }
 
 void
-FullYansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<FullInterferenceHelper::Event> event)
+FullYansWifiPhy::EndReceive (Ptr<const Packet> packet, Ptr<FullInterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -926,7 +986,8 @@ FullYansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<FullInterferenceHelper::Eve
       double signalDbm = RatioToDb (event->GetRxPowerW ()) + 30;
       double noiseDbm = RatioToDb (event->GetRxPowerW () / snrPer.snr) - GetRxNoiseFigure () + 30;
       NotifyMonitorSniffRx (packet, (uint16_t)GetChannelFrequencyMhz (), GetChannelNumber (), dataRate500KbpsUnits, isShortPreamble, signalDbm, noiseDbm);
-      m_receiveState->SwitchFromRxEndOk (packet, snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
+      // the packet is shared by all the receivers of the transmission
+      m_receiveState->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetPayloadMode (), event->GetPreambleType ());
     }
   else
     {
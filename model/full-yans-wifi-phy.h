@@ -27,6 +27,7 @@
 #include "ns3/packet.h"
 #include "ns3/object.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
@@ -86,13 +87,31 @@ public:
   void SetChannelNumber (uint16_t id);
   /// Return current channel number, see SetChannelNumber()
   uint16_t GetChannelNumber () const;
+  /// Return the index of this PHY in the PHY list of its channel
+  uint32_t GetChannelIndex (void) const;
   /// Return current center channel frequency in MHz, see SetChannelNumber()
   double GetChannelFrequencyMhz () const;
 
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            FullWifiMode mode,
-                           FullWifiPreamble preamble);
+                           FullWifiPreamble preamble,
+                           const FullWifiTxMetadata &metadata);
+  /**
+   * \param rxPowerDbm the rx power (before rx gain) of a far-field
+   *        transmission which starts now
+   *
+   * Far-field transmissions are not received: they only raise the
+   * background interference level until the matching
+   * RemoveFarFieldInterference. The aggregate does not make the CCA
+   * report the medium busy by itself.
+   */
+  void AddFarFieldInterference (double rxPowerDbm);
+  /**
+   * \param rxPowerDbm the rx power (before rx gain) of a far-field
+   *        transmission which ends now
+   */
+  void RemoveFarFieldInterference (double rxPowerDbm);
 
   void SetRxNoiseFigure (double noiseFigureDb);
   void SetTxPowerStart (double start);
@@ -102,6 +121,11 @@ public:
   void SetRxGain (double gain);
   void SetEdThreshold (double threshold);
   void SetCcaMode1Threshold (double threshold);
+  /**
+   * \param threshold the power (dBm) below which incoming signals are
+   *        ignored instead of being tracked as interference
+   */
+  void SetInterferenceFloor (double threshold);
   void SetErrorRateModel (Ptr<FullErrorRateModel> rate);
   void SetDevice (Ptr<Object> device);
   void SetMobility (Ptr<Object> mobility);
@@ -110,6 +134,7 @@ public:
   double GetRxGain (void) const;
   double GetEdThreshold (void) const;
   double GetCcaMode1Threshold (void) const;
+  double GetInterferenceFloor (void) const;
   Ptr<FullErrorRateModel> GetErrorRateModel (void) const;
   Ptr<Object> GetDevice (void) const;
   Ptr<Object> GetMobility (void);
@@ -127,7 +152,8 @@ public:
   virtual uint32_t GetNTxPower (void) const;
   virtual void SetReceiveOkCallback (FullWifiPhy::RxOkCallback callback);
   virtual void SetReceiveErrorCallback (FullWifiPhy::RxErrorCallback callback);
-  virtual void SendPacket (Ptr<const Packet> packet, FullWifiMode mode, enum FullWifiPreamble preamble, uint8_t txPowerLevel);
+  virtual void SendPacket (Ptr<const Packet> packet, FullWifiMode mode, enum FullWifiPreamble preamble, uint8_t txPowerLevel,
+                           const FullWifiTxMetadata &metadata = FullWifiTxMetadata ());
   virtual void RegisterListener (FullWifiPhyListener *listener);
   virtual bool IsStateCcaBusy (void);
   virtual bool IsRxStateIdle (void);
@@ -175,11 +201,12 @@ private:
   double WToDbm (double w) const;
   double RatioToDb (double ratio) const;
   double GetPowerDbm (uint8_t power) const;
-  void EndReceive (Ptr<Packet> packet, Ptr<FullInterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, Ptr<FullInterferenceHelper::Event> event);
 
 private:
   double   m_edThresholdW;
   double   m_ccaMode1ThresholdW;
+  double   m_interferenceFloorW;
   double   m_txGainDb;
   double   m_rxGainDb;
   double   m_txPowerBaseDbm;
@@ -187,6 +214,7 @@ private:
   uint32_t m_nTxPower;
 
   Ptr<FullYansWifiChannel> m_channel;
+  uint32_t m_channelIndex;  //!< index in the PHY list of m_channel
   uint16_t m_channelNumber;
   Ptr<Object> m_device;
   Ptr<Object> m_mobility;
@@ -245,6 +273,13 @@ private:
   // higher than the current receiving packet
   double m_captureEffectThreshold;
 
+  //number of arrivals ignored because they were below the interference floor
+  TracedValue<uint64_t> m_negligibleArrivals;
+
+  //aggregate power and number of the far-field transmissions heard
+  double m_farFieldW;
+  uint32_t m_nFarField;
+
 };
 
 } // namespace ns3
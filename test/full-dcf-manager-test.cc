@@ -38,7 +38,7 @@ private:
   virtual void DoNotifyCollision (void);
   virtual void DoNotifyChannelSwitching (void);
 
-  virtual void DoNotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble);
+  virtual void DoNotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble);
 
   typedef std::pair<uint64_t,uint64_t> ExpectedGrant;
   typedef std::list<ExpectedGrant> ExpectedGrants;
@@ -140,7 +140,7 @@ FullDcfStateTest::DoNotifyChannelSwitching (void)
 }
 
 void
-FullDcfStateTest::DoNotifyRxStartNow (Time duration, Ptr<const Packet> packet, FullWifiMode txMode, FullWifiPreamble preamble)
+FullDcfStateTest::DoNotifyRxStartNow (Time duration, Ptr<const FullWifiRxFrame> frame, FullWifiMode txMode, FullWifiPreamble preamble)
 {
 
 }
@@ -261,7 +261,8 @@ FullDcfManagerTest::AddRxOkEvt (uint64_t at, uint64_t duration)
 {
   Simulator::Schedule (MicroSeconds (at) - Now (),
                        &FullDcfManager::NotifyRxStartNow, m_dcfManager,
-                       MicroSeconds (duration), Create<Packet>(0), FullWifiMode(), FullWifiPreamble());
+                       MicroSeconds (duration), Create<FullWifiRxFrame> (Create<Packet> (0), FullWifiTxMetadata ()),
+                       FullWifiMode(), FullWifiPreamble());
   Simulator::Schedule (MicroSeconds (at + duration) - Now (),
                        &FullDcfManager::NotifyRxEndOkNow, m_dcfManager);
 }
@@ -270,14 +271,16 @@ FullDcfManagerTest::AddRxInsideSifsEvt (uint64_t at, uint64_t duration)
 {
   Simulator::Schedule (MicroSeconds (at) - Now (),
                        &FullDcfManager::NotifyRxStartNow, m_dcfManager,
-                       MicroSeconds (duration), Create<Packet>(0), FullWifiMode(), FullWifiPreamble());
+                       MicroSeconds (duration), Create<FullWifiRxFrame> (Create<Packet> (0), FullWifiTxMetadata ()),
+                       FullWifiMode(), FullWifiPreamble());
 }
 void
 FullDcfManagerTest::AddRxErrorEvt (uint64_t at, uint64_t duration)
 {
   Simulator::Schedule (MicroSeconds (at) - Now (),
                        &FullDcfManager::NotifyRxStartNow, m_dcfManager,
-                       MicroSeconds (duration), Create<Packet>(0), FullWifiMode(), FullWifiPreamble());
+                       MicroSeconds (duration), Create<FullWifiRxFrame> (Create<Packet> (0), FullWifiTxMetadata ()),
+                       FullWifiMode(), FullWifiPreamble());
   Simulator::Schedule (MicroSeconds (at + duration) - Now (),
                        &FullDcfManager::NotifyRxEndErrorNow, m_dcfManager);
 }
@@ -351,7 +354,8 @@ FullDcfManagerTest::AddRxStartEvt (uint64_t at, uint64_t duration)
 {
   Simulator::Schedule (MicroSeconds (at) - Now (),
                        &FullDcfManager::NotifyRxStartNow, m_dcfManager,
-                       MicroSeconds (duration), Create<Packet>(0), FullWifiMode(), FullWifiPreamble());
+                       MicroSeconds (duration), Create<FullWifiRxFrame> (Create<Packet> (0), FullWifiTxMetadata ()),
+                       FullWifiMode(), FullWifiPreamble());
 }
 
 
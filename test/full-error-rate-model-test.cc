@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/full-wifi-phy.h"
+#include "ns3/full-nist-error-rate-model.h"
+#include "ns3/full-yans-error-rate-model.h"
+#include "ns3/full-dsss-error-rate-model.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+class FullErrorRateTableTest : public TestCase
+{
+public:
+  FullErrorRateTableTest (std::string type);
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \return the largest absolute difference between the chunk success
+   *         rates of the two models between minDb and maxDb
+   */
+  double GetMaxError (Ptr<FullErrorRateModel> exact, Ptr<FullErrorRateModel> table,
+                      double minDb, double maxDb, double stepDb);
+
+  std::string m_type;
+  std::vector<FullWifiMode> m_modes;
+};
+
+FullErrorRateTableTest::FullErrorRateTableTest (std::string type)
+  : TestCase ("Tabulated chunk success rate of " + type),
+    m_type (type)
+{
+}
+
+double
+FullErrorRateTableTest::GetMaxError (Ptr<FullErrorRateModel> exact, Ptr<FullErrorRateModel> table,
+                                     double minDb, double maxDb, double stepDb)
+{
+  static const uint32_t nbits[] = { 1, 100, 1000, 12000, 100000 };
+  double maxError = 0;
+  for (uint32_t m = 0; m < m_modes.size (); m++)
+    {
+      for (double snrDb = minDb; snrDb <= maxDb; snrDb += stepDb)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t n = 0; n < sizeof (nbits) / sizeof (nbits[0]); n++)
+            {
+              double error = std::abs (exact->GetChunkSuccessRate (m_modes[m], snr, nbits[n])
+                                       - table->GetChunkSuccessRate (m_modes[m], snr, nbits[n]));
+              maxError = std::max (maxError, error);
+            }
+        }
+    }
+  return maxError;
+}
+
+void
+FullErrorRateTableTest::DoRun (void)
+{
+  m_modes.push_back (FullWifiPhy::GetOfdmRate6Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate9Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate12Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate18Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate24Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate36Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate48Mbps ());
+  m_modes.push_back (FullWifiPhy::GetOfdmRate54Mbps ());
+
+  ObjectFactory factory;
+  factory.SetTypeId (m_type);
+  factory.Set ("UseTable", BooleanValue (false));
+  Ptr<FullErrorRateModel> exact = factory.Create<FullErrorRateModel> ();
+  factory.Set ("UseTable", BooleanValue (true));
+  Ptr<FullErrorRateModel> table = factory.Create<FullErrorRateModel> ();
+
+  // a quarter of the 0.05 dB table step: the grid nodes and three points
+  // between each pair of them
+  double maxError = GetMaxError (exact, table, -10.0, 40.0, 0.0125);
+  NS_TEST_EXPECT_MSG_LT (maxError, 2e-4, "tabulated success rate too far from the exact one");
+
+  // outside of the table, the exact formula is used
+  maxError = GetMaxError (exact, table, 40.5, 45.0, 0.5);
+  NS_TEST_EXPECT_MSG_EQ (maxError, 0.0, "no fallback to the exact formula beyond TableMaxSnr");
+
+  // the table is rebuilt when its layout changes
+  table->SetAttribute ("TableStep", DoubleValue (0.01));
+  table->SetAttribute ("TableMaxSnr", DoubleValue (30.0));
+  maxError = GetMaxError (exact, table, -10.0, 30.0, 0.0037);
+  NS_TEST_EXPECT_MSG_LT (maxError, 2e-4, "stale table used after a change of TableStep");
+  maxError = GetMaxError (exact, table, 30.5, 40.0, 0.5);
+  NS_TEST_EXPECT_MSG_EQ (maxError, 0.0, "no fallback to the exact formula beyond the new TableMaxSnr");
+
+  // UseTable can be turned off at any time
+  table->SetAttribute ("UseTable", BooleanValue (false));
+  maxError = GetMaxError (exact, table, -10.0, 40.0, 0.33);
+  NS_TEST_EXPECT_MSG_EQ (maxError, 0.0, "the exact formula is not used without UseTable");
+}
+
+#ifdef FULL_ENABLE_GSL
+class FullDsssCckTableTest : public TestCase
+{
+public:
+  FullDsssCckTableTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param e2 the energy per symbol to noise ratio
+   * \return the symbol error probability of equation (18), integrated
+   *         without the table of FullDsssErrorRateModel
+   */
+  double Integrate (double e2);
+
+  gsl_integration_workspace *m_workspace;
+};
+
+FullDsssCckTableTest::FullDsssCckTableTest ()
+  : TestCase ("Tabulated CCK symbol error probability of the DSSS model"),
+    m_workspace (0)
+{
+}
+
+double
+FullDsssCckTableTest::Integrate (double e2)
+{
+  FunctionParameters params;
+  params.beta = std::sqrt (2.0 * e2);
+  params.n = 8.0;
+  gsl_function F;
+  F.function = &IntegralFunction;
+  F.params = &params;
+  double sep;
+  double error;
+  gsl_integration_qagiu (&F, -params.beta, 0, 1e-7, 1000, m_workspace, &sep, &error);
+  if (error == 0.0)
+    {
+      sep = 1.0;
+    }
+  return 1.0 - sep;
+}
+
+void
+FullDsssCckTableTest::DoRun (void)
+{
+  m_workspace = gsl_integration_workspace_alloc (1000);
+  double maxError = 0;
+  double maxRelativeError = 0;
+  // the table spans -10 dB to 30 dB with a 0.05 dB step: visit its nodes
+  // and three points between each pair of them
+  for (double db = -10.0; db < 30.0; db += 0.0125)
+    {
+      double e2 = std::pow (10.0, db / 10.0);
+      double exact = Integrate (e2);
+      double error = std::abs (FullDsssErrorRateModel::SymbolErrorProb16Cck (e2) - exact);
+      maxError = std::max (maxError, error);
+      // below 1e-9, the integral is dominated by its own rounding errors
+      if (exact > 1e-9)
+        {
+          maxRelativeError = std::max (maxRelativeError, error / exact);
+        }
+    }
+  gsl_integration_workspace_free (m_workspace);
+  m_workspace = 0;
+  NS_TEST_EXPECT_MSG_LT (maxError, 1e-5, "tabulated symbol error probability too far from the integral");
+  NS_TEST_EXPECT_MSG_LT (maxRelativeError, 1e-3, "tabulated symbol error probability too far from the integral");
+
+  // outside of the table, the integral is used
+  for (double db = 30.5; db <= 35.0; db += 0.5)
+    {
+      double e2 = std::pow (10.0, db / 10.0);
+      NS_TEST_EXPECT_MSG_EQ_TOL (FullDsssErrorRateModel::SymbolErrorProb16Cck (e2), Integrate (e2), 1e-12,
+                                 "no fallback to the integral beyond the table");
+    }
+}
+#endif
+
+class FullErrorRateModelTestSuite : public TestSuite
+{
+public:
+  FullErrorRateModelTestSuite ();
+};
+
+FullErrorRateModelTestSuite::FullErrorRateModelTestSuite ()
+  : TestSuite ("devices-wifi-error-rate-models", UNIT)
+{
+  AddTestCase (new FullErrorRateTableTest ("ns3::FullNistErrorRateModel"));
+  AddTestCase (new FullErrorRateTableTest ("ns3::FullYansErrorRateModel"));
+#ifdef FULL_ENABLE_GSL
+  AddTestCase (new FullDsssCckTableTest ());
+#endif
+}
+
+static FullErrorRateModelTestSuite g_errorRateModelTestSuite;
+
+} // namespace ns3
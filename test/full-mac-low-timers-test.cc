@@ -0,0 +1,309 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/full-mac-low.h"
+
+namespace ns3 {
+
+class FullMacLowTimersTest : public TestCase
+{
+public:
+  FullMacLowTimersTest ();
+  virtual void DoRun (void);
+
+private:
+  /// id recorded by Marker, after the ids of the timers
+  static const uint32_t MARKER = 100;
+
+  void StartTest (void);
+  void EndTest (void);
+  /**
+   * \param id the id recorded at the expiration
+   * \param at the time, in microseconds, at which the expiration is expected
+   */
+  void ExpectExpiration (uint32_t id, uint64_t at);
+  void AddSchedule (uint64_t at, uint32_t timer, uint64_t delay);
+  void AddCancel (uint64_t at, uint32_t timer);
+  void AddCancelAll (uint64_t at);
+  /**
+   * \param at the time at which the marker is scheduled
+   * \param delay the delay after which the marker runs
+   */
+  void AddMarker (uint64_t at, uint64_t delay);
+
+  void DoSchedule (uint32_t timer, uint64_t delay);
+  void DoCancel (uint32_t timer);
+  void DoCancelAll (void);
+  void DoMarker (uint64_t delay);
+  void Marker (void);
+  void Expire0 (void);
+  void Expire1 (void);
+  void Expire2 (void);
+  void Record (uint32_t id);
+
+  typedef std::vector<std::pair<uint32_t, uint64_t> > Expirations;
+
+  FullMacLowTimers *m_timers;
+  Expirations m_expected;
+  Expirations m_expired;
+  uint32_t m_rearm;  //!< number of times Expire0 restarts its own timer
+};
+
+FullMacLowTimersTest::FullMacLowTimersTest ()
+  : TestCase ("FullMacLowTimers"),
+    m_timers (0),
+    m_rearm (0)
+{
+}
+
+void
+FullMacLowTimersTest::StartTest (void)
+{
+  m_timers = new FullMacLowTimers ();
+  NS_TEST_EXPECT_MSG_EQ (m_timers->Add (MakeCallback (&FullMacLowTimersTest::Expire0, this)), 0u, "unexpected timer id");
+  NS_TEST_EXPECT_MSG_EQ (m_timers->Add (MakeCallback (&FullMacLowTimersTest::Expire1, this)), 1u, "unexpected timer id");
+  NS_TEST_EXPECT_MSG_EQ (m_timers->Add (MakeCallback (&FullMacLowTimersTest::Expire2, this)), 2u, "unexpected timer id");
+  m_expected.clear ();
+  m_expired.clear ();
+  m_rearm = 0;
+}
+
+void
+FullMacLowTimersTest::EndTest (void)
+{
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_expired.size (), m_expected.size (), "unexpected number of expirations");
+  for (uint32_t i = 0; i < m_expired.size () && i < m_expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_expired[i].first, m_expected[i].first, "expiration " << i << " of the wrong timer");
+      NS_TEST_EXPECT_MSG_EQ (m_expired[i].second, m_expected[i].second, "expiration " << i << " at the wrong time");
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_timers->IsRunning (i), false, "timer " << i << " still running");
+    }
+  Simulator::Destroy ();
+  delete m_timers;
+  m_timers = 0;
+}
+
+void
+FullMacLowTimersTest::ExpectExpiration (uint32_t id, uint64_t at)
+{
+  m_expected.push_back (std::make_pair (id, at));
+}
+
+void
+FullMacLowTimersTest::AddSchedule (uint64_t at, uint32_t timer, uint64_t delay)
+{
+  Simulator::Schedule (MicroSeconds (at), &FullMacLowTimersTest::DoSchedule, this, timer, delay);
+}
+
+void
+FullMacLowTimersTest::AddCancel (uint64_t at, uint32_t timer)
+{
+  Simulator::Schedule (MicroSeconds (at), &FullMacLowTimersTest::DoCancel, this, timer);
+}
+
+void
+FullMacLowTimersTest::AddCancelAll (uint64_t at)
+{
+  Simulator::Schedule (MicroSeconds (at), &FullMacLowTimersTest::DoCancelAll, this);
+}
+
+void
+FullMacLowTimersTest::AddMarker (uint64_t at, uint64_t delay)
+{
+  Simulator::Schedule (MicroSeconds (at), &FullMacLowTimersTest::DoMarker, this, delay);
+}
+
+void
+FullMacLowTimersTest::DoSchedule (uint32_t timer, uint64_t delay)
+{
+  m_timers->Schedule (timer, MicroSeconds (delay));
+  NS_TEST_EXPECT_MSG_EQ (m_timers->IsRunning (timer), true, "timer " << timer << " not started");
+}
+
+void
+FullMacLowTimersTest::DoCancel (uint32_t timer)
+{
+  m_timers->Cancel (timer);
+  NS_TEST_EXPECT_MSG_EQ (m_timers->IsExpired (timer), true, "timer " << timer << " not cancelled");
+}
+
+void
+FullMacLowTimersTest::DoCancelAll (void)
+{
+  m_timers->CancelAll ();
+}
+
+void
+FullMacLowTimersTest::DoMarker (uint64_t delay)
+{
+  Simulator::Schedule (MicroSeconds (delay), &FullMacLowTimersTest::Marker, this);
+}
+
+void
+FullMacLowTimersTest::Marker (void)
+{
+  Record (MARKER);
+}
+
+void
+FullMacLowTimersTest::Expire0 (void)
+{
+  Record (0);
+  if (m_rearm > 0)
+    {
+      m_rearm--;
+      m_timers->Schedule (0, MicroSeconds (10));
+    }
+}
+
+void
+FullMacLowTimersTest::Expire1 (void)
+{
+  Record (1);
+}
+
+void
+FullMacLowTimersTest::Expire2 (void)
+{
+  Record (2);
+}
+
+void
+FullMacLowTimersTest::Record (uint32_t id)
+{
+  if (id != MARKER)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_timers->IsRunning (id), false, "timer " << id << " still running in its handler");
+    }
+  m_expired.push_back (std::make_pair (id, Simulator::Now ().GetMicroSeconds ()));
+}
+
+void
+FullMacLowTimersTest::DoRun (void)
+{
+  // a single timer
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  ExpectExpiration (0, 10);
+  EndTest ();
+
+  // moving a deadline later: nothing expires at the old deadline
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  AddSchedule (5, 0, 20);
+  ExpectExpiration (0, 25);
+  EndTest ();
+
+  // moving a deadline earlier
+  StartTest ();
+  AddSchedule (0, 0, 30);
+  AddSchedule (5, 0, 5);
+  ExpectExpiration (0, 10);
+  EndTest ();
+
+  // several timers expire in deadline order
+  StartTest ();
+  AddSchedule (0, 0, 30);
+  AddSchedule (0, 1, 10);
+  AddSchedule (0, 2, 20);
+  ExpectExpiration (1, 10);
+  ExpectExpiration (2, 20);
+  ExpectExpiration (0, 30);
+  EndTest ();
+
+  // cancelling the earliest of several running timers
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  AddSchedule (0, 1, 20);
+  AddSchedule (0, 2, 30);
+  AddCancel (5, 0);
+  ExpectExpiration (1, 20);
+  ExpectExpiration (2, 30);
+  EndTest ();
+
+  // cancelling a later one
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  AddSchedule (0, 1, 20);
+  AddSchedule (0, 2, 30);
+  AddCancel (5, 1);
+  ExpectExpiration (0, 10);
+  ExpectExpiration (2, 30);
+  EndTest ();
+
+  // a handler restarting its own timer
+  StartTest ();
+  m_rearm = 2;
+  AddSchedule (0, 0, 10);
+  AddSchedule (0, 1, 25);
+  ExpectExpiration (0, 10);
+  ExpectExpiration (0, 20);
+  ExpectExpiration (1, 25);
+  ExpectExpiration (0, 30);
+  EndTest ();
+
+  // CancelAll stops every timer and removes the wakeup
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  AddSchedule (0, 1, 20);
+  AddSchedule (0, 2, 30);
+  AddCancelAll (5);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MicroSeconds (5), "a wakeup is still scheduled after CancelAll");
+  EndTest ();
+
+  // a timer stopped by CancelAll can be started again
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  AddCancelAll (5);
+  AddSchedule (6, 0, 10);
+  ExpectExpiration (0, 16);
+  EndTest ();
+
+  // the wakeup of an extended deadline is scheduled when the old
+  // deadline is reached, not when the deadline is moved: the timeout runs
+  // after an event scheduled at 5us for the same time, where cancelling
+  // and rescheduling at 2us would run it before
+  StartTest ();
+  AddSchedule (0, 0, 10);
+  AddSchedule (2, 0, 20);
+  AddMarker (5, 17);
+  ExpectExpiration (MARKER, 22);
+  ExpectExpiration (0, 22);
+  EndTest ();
+}
+
+class FullMacLowTimersTestSuite : public TestSuite
+{
+public:
+  FullMacLowTimersTestSuite ();
+};
+
+FullMacLowTimersTestSuite::FullMacLowTimersTestSuite ()
+  : TestSuite ("devices-wifi-mac-low-timers", UNIT)
+{
+  AddTestCase (new FullMacLowTimersTest);
+}
+
+static FullMacLowTimersTestSuite g_macLowTimersTestSuite;
+
+} // namespace ns3
@@ -179,6 +179,89 @@ FullTxDurationTest::DoRun (void)
     && CheckTxDuration (14, FullWifiPhy::GetErpOfdmRate54Mbps (), FULL_WIFI_PREAMBLE_LONG, 30);
 }
 
+/**
+ * Check that the memoized CalculateTxDuration returns exactly the
+ * durations computed from the PLCP preamble, PLCP header and payload,
+ * both when an entry is first filled and when it is read back, and
+ * beyond the sizes it memoizes.
+ */
+class FullTxDurationCacheTest : public TestCase
+{
+public:
+  FullTxDurationCacheTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param size size of payload in octets
+   * \param payloadMode the WifiMode used
+   * \param preamble the WifiPreamble used
+   *
+   * \return true if the two successive calls to CalculateTxDuration
+   * match the uncached duration, false otherwise
+   */
+  bool CheckCachedTxDuration (uint32_t size, FullWifiMode payloadMode, FullWifiPreamble preamble);
+};
+
+FullTxDurationCacheTest::FullTxDurationCacheTest ()
+  : TestCase ("Wifi TX Duration cache")
+{
+}
+
+bool
+FullTxDurationCacheTest::CheckCachedTxDuration (uint32_t size, FullWifiMode payloadMode, FullWifiPreamble preamble)
+{
+  uint32_t expected = FullWifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)
+    + FullWifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)
+    + FullWifiPhy::GetPayloadDurationMicroSeconds (size, payloadMode);
+  Time first = FullWifiPhy::CalculateTxDuration (size, payloadMode, preamble);
+  Time second = FullWifiPhy::CalculateTxDuration (size, payloadMode, preamble);
+  if (first != MicroSeconds (expected) || second != MicroSeconds (expected))
+    {
+      std::cerr << " size=" << size
+                << " mode=" << payloadMode
+                << " preamble=" << preamble
+                << " expected=" << expected
+                << " first=" << first.GetMicroSeconds ()
+                << " second=" << second.GetMicroSeconds ()
+                << std::endl;
+      return false;
+    }
+  return true;
+}
+
+void
+FullTxDurationCacheTest::DoRun (void)
+{
+  FullWifiMode modes[] = {
+    FullWifiPhy::GetDsssRate1Mbps (),
+    FullWifiPhy::GetDsssRate5_5Mbps (),
+    FullWifiPhy::GetDsssRate11Mbps (),
+    FullWifiPhy::GetErpOfdmRate6Mbps (),
+    FullWifiPhy::GetErpOfdmRate54Mbps (),
+    FullWifiPhy::GetOfdmRate6Mbps (),
+    FullWifiPhy::GetOfdmRate54Mbps (),
+    FullWifiPhy::GetOfdmRate3MbpsBW10MHz (),
+    FullWifiPhy::GetOfdmRate1_5MbpsBW5MHz ()
+  };
+  FullWifiPreamble preambles[] = { FULL_WIFI_PREAMBLE_LONG, FULL_WIFI_PREAMBLE_SHORT };
+  // ACK/CTS, RTS, typical data sizes, and sizes around the end of the cache
+  uint32_t sizes[] = { 0, 1, 14, 20, 76, 1023, 1536, 2304, 2346, 4095, 4096, 4097, 8000 };
+
+  bool retval = true;
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      for (uint32_t p = 0; p < sizeof (preambles) / sizeof (preambles[0]); p++)
+        {
+          for (uint32_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+            {
+              retval = CheckCachedTxDuration (sizes[s], modes[m], preambles[p]) && retval;
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (retval, true, "memoized tx durations differ from the computed ones");
+}
+
 class TxDurationTestSuite : public TestSuite
 {
 public:
@@ -189,6 +272,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new FullTxDurationTest);
+  AddTestCase (new FullTxDurationCacheTest);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite;
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/full-wifi-mac-queue.h"
+#include <vector>
+
+namespace ns3 {
+
+class FullWifiMacQueueTest : public TestCase
+{
+public:
+  FullWifiMacQueueTest ();
+  virtual void DoRun (void);
+
+private:
+  FullWifiMacHeader MakeHeader (Mac48Address to) const;
+  void AdvanceTo (Time t);
+  void TestExpiry (void);
+  void TestPushFront (void);
+  void TestRemove (void);
+  void TestMaxSize (void);
+  void TestDestinations (void);
+  void TestPeekByDestination (void);
+};
+
+FullWifiMacQueueTest::FullWifiMacQueueTest ()
+  : TestCase ("FullWifiMacQueue expiry, removal, size limit and destination index")
+{
+}
+
+FullWifiMacHeader
+FullWifiMacQueueTest::MakeHeader (Mac48Address to) const
+{
+  FullWifiMacHeader hdr;
+  hdr.SetType (FULL_WIFI_MAC_DATA);
+  hdr.SetAddr1 (to);
+  return hdr;
+}
+
+void
+FullWifiMacQueueTest::AdvanceTo (Time t)
+{
+  Simulator::Stop (t - Simulator::Now ());
+  Simulator::Run ();
+}
+
+void
+FullWifiMacQueueTest::TestExpiry (void)
+{
+  Ptr<FullWifiMacQueue> queue = CreateObject<FullWifiMacQueue> ();
+  queue->SetMaxDelay (Seconds (1.0));
+  FullWifiMacHeader hdr = MakeHeader (Mac48Address ("00:00:00:00:00:01"));
+  Ptr<Packet> a = Create<Packet> (100);
+  Ptr<Packet> b = Create<Packet> (100);
+  Ptr<Packet> c = Create<Packet> (100);
+
+  queue->Enqueue (a, hdr);
+  AdvanceTo (Seconds (0.5));
+  queue->Enqueue (b, hdr);
+  // c is younger than b but inserted at the head
+  AdvanceTo (Seconds (0.8));
+  queue->PushFront (c, hdr);
+
+  AdvanceTo (Seconds (1.2));
+  FullWifiMacHeader out;
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek (&out), c, "a has expired, c is at the head");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 2u, "a has expired");
+  AdvanceTo (Seconds (1.6));
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), c, "b has expired behind c");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 0u, "b has expired");
+  AdvanceTo (Seconds (2.0));
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "every packet left the queue");
+  Simulator::Destroy ();
+}
+
+void
+FullWifiMacQueueTest::TestPushFront (void)
+{
+  Ptr<FullWifiMacQueue> queue = CreateObject<FullWifiMacQueue> ();
+  FullWifiMacHeader hdr = MakeHeader (Mac48Address ("00:00:00:00:00:01"));
+  Ptr<Packet> a = Create<Packet> (100);
+  Ptr<Packet> b = Create<Packet> (100);
+  Ptr<Packet> c = Create<Packet> (100);
+  Ptr<Packet> d = Create<Packet> (100);
+  FullWifiMacHeader out;
+
+  queue->Enqueue (a, hdr);
+  queue->Enqueue (b, hdr);
+  queue->Enqueue (c, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), a, "FIFO order");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b, "FIFO order");
+  // both take the positions a and b left behind
+  queue->PushFront (b, hdr);
+  queue->PushFront (d, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 3u, "d, b and c are queued");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), d, "pushed to the front last");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b, "pushed to the front first");
+  queue->Enqueue (a, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), c, "enqueued before the front pushes");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), a, "enqueued last");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "every packet was dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), 0, "nothing left to dequeue");
+  Simulator::Destroy ();
+}
+
+void
+FullWifiMacQueueTest::TestRemove (void)
+{
+  Ptr<FullWifiMacQueue> queue = CreateObject<FullWifiMacQueue> ();
+  FullWifiMacHeader hdr = MakeHeader (Mac48Address ("00:00:00:00:00:01"));
+  Ptr<Packet> a = Create<Packet> (100);
+  Ptr<Packet> b = Create<Packet> (100);
+  Ptr<Packet> c = Create<Packet> (100);
+  Ptr<Packet> d = Create<Packet> (100);
+  FullWifiMacHeader out;
+
+  queue->Enqueue (a, hdr);
+  queue->Enqueue (b, hdr);
+  queue->Enqueue (c, hdr);
+  queue->Enqueue (d, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (b), true, "b is queued");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (b), false, "b was already removed");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (d), true, "d is queued");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 2u, "a and c are left");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), a, "the head is unchanged");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), false, "c is left");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 1u, "c is left");
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek (&out), c, "the slot of b is skipped");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), c, "the slot of b is skipped");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "the slot of d is not a packet");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 0u, "the slot of d is not a packet");
+  queue->Enqueue (b, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b, "the queue is reusable");
+  Simulator::Destroy ();
+}
+
+void
+FullWifiMacQueueTest::TestMaxSize (void)
+{
+  Ptr<FullWifiMacQueue> queue = CreateObject<FullWifiMacQueue> ();
+  queue->SetMaxSize (2);
+  FullWifiMacHeader hdr = MakeHeader (Mac48Address ("00:00:00:00:00:01"));
+  Ptr<Packet> a = Create<Packet> (100);
+  Ptr<Packet> b = Create<Packet> (100);
+  Ptr<Packet> c = Create<Packet> (100);
+  Ptr<Packet> d = Create<Packet> (100);
+  FullWifiMacHeader out;
+
+  queue->Enqueue (a, hdr);
+  queue->Enqueue (b, hdr);
+  // a full queue drops new packets, at either end
+  queue->Enqueue (c, hdr);
+  queue->PushFront (d, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 2u, "the queue holds MaxPacketNumber packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (c), false, "c was dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (d), false, "d was dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), a, "the queued packets are kept");
+  queue->Enqueue (c, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 2u, "a dequeue makes room for one packet");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b, "the queued packets are kept");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), c, "c was queued after the dequeue");
+  Simulator::Destroy ();
+}
+
+void
+FullWifiMacQueueTest::TestDestinations (void)
+{
+  Ptr<FullWifiMacQueue> queue = CreateObject<FullWifiMacQueue> ();
+  Mac48Address addrA ("00:00:00:00:00:0a");
+  Mac48Address addrB ("00:00:00:00:00:0b");
+  FullWifiMacHeader hdrA = MakeHeader (addrA);
+  FullWifiMacHeader hdrB = MakeHeader (addrB);
+  Ptr<Packet> a1 = Create<Packet> (100);
+  Ptr<Packet> a2 = Create<Packet> (100);
+  Ptr<Packet> a3 = Create<Packet> (100);
+  Ptr<Packet> a4 = Create<Packet> (100);
+  Ptr<Packet> b1 = Create<Packet> (100);
+  Ptr<Packet> b2 = Create<Packet> (100);
+  FullWifiMacHeader out;
+
+  queue->Enqueue (a1, hdrA);
+  queue->Enqueue (b1, hdrB);
+  queue->Enqueue (a2, hdrA);
+  queue->Enqueue (b2, hdrB);
+  queue->Enqueue (a3, hdrA);
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (a2), true, "a2 is queued");
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekFirstAvailable (&out, addrA), a1, "first packet for A");
+  NS_TEST_EXPECT_MSG_EQ (out.GetAddr1 (), addrA, "header of the first packet for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrA), a1, "first packet for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekFirstAvailable (&out, addrA), a3, "a2 was removed");
+
+  // b1 leaves the head, a4 takes the position a2 left behind
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b1, "FIFO order");
+  queue->PushFront (a4, hdrA);
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrA), a4, "a4 was pushed in front of a3");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrA), a3, "a3 is the last packet for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrA), 0, "no packet left for A");
+
+  // a position of A is reused by a packet for B
+  queue->PushFront (b1, hdrB);
+  NS_TEST_EXPECT_MSG_EQ (queue->PeekFirstAvailable (&out, addrA), 0, "no packet left for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrB), b1, "b1 was pushed in front of b2");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrB), b2, "b2 is the last packet for B");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "every packet was dequeued");
+
+  // the destinations can be used again once they were emptied
+  queue->Enqueue (a1, hdrA);
+  queue->Enqueue (b1, hdrB);
+  queue->Enqueue (a2, hdrA);
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrA), a1, "first packet for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b1, "FIFO order");
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueFirstAvailable (&out, addrA), a2, "last packet for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 0u, "every packet was dequeued");
+  Simulator::Destroy ();
+}
+
+void
+FullWifiMacQueueTest::TestPeekByDestination (void)
+{
+  Ptr<FullWifiMacQueue> queue = CreateObject<FullWifiMacQueue> ();
+  Mac48Address addrA ("00:00:00:00:00:0a");
+  Mac48Address addrB ("00:00:00:00:00:0b");
+  FullWifiMacHeader hdrA = MakeHeader (addrA);
+  FullWifiMacHeader hdrB = MakeHeader (addrB);
+  Ptr<Packet> a1 = Create<Packet> (100);
+  Ptr<Packet> a2 = Create<Packet> (100);
+  Ptr<Packet> a3 = Create<Packet> (100);
+  Ptr<Packet> a4 = Create<Packet> (100);
+  Ptr<Packet> b1 = Create<Packet> (100);
+  std::vector<Ptr<const Packet> > packets;
+  std::vector<FullWifiMacHeader> hdrs;
+  FullWifiMacHeader out;
+
+  queue->Enqueue (a1, hdrA);
+  queue->Enqueue (b1, hdrB);
+  queue->Enqueue (a2, hdrA);
+  queue->Enqueue (a3, hdrA);
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (a2), true, "a2 is queued");
+
+  queue->PeekByDestination (addrA, 10, &packets, &hdrs);
+  NS_TEST_ASSERT_MSG_EQ (packets.size (), 2u, "a2 was removed");
+  NS_TEST_ASSERT_MSG_EQ (hdrs.size (), 2u, "one header per packet");
+  NS_TEST_EXPECT_MSG_EQ (packets[0], a1, "FIFO order for A");
+  NS_TEST_EXPECT_MSG_EQ (packets[1], a3, "FIFO order for A");
+  NS_TEST_EXPECT_MSG_EQ (hdrs[0].GetAddr1 (), addrA, "header of a1");
+  NS_TEST_EXPECT_MSG_EQ (hdrs[1].GetAddr1 (), addrA, "header of a3");
+  queue->PeekByDestination (addrA, 1, &packets, &hdrs);
+  NS_TEST_ASSERT_MSG_EQ (packets.size (), 1u, "at most max packets are listed");
+  NS_TEST_EXPECT_MSG_EQ (packets[0], a1, "the first packet for A is listed");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 3u, "peeking does not remove anything");
+
+  NS_TEST_EXPECT_MSG_EQ (queue->RemoveByDestination (addrB, a1), false, "a1 is not queued for B");
+  NS_TEST_EXPECT_MSG_EQ (queue->RemoveByDestination (addrA, a3), true, "a3 is queued for A");
+  NS_TEST_EXPECT_MSG_EQ (queue->RemoveByDestination (addrA, a3), false, "a3 was already removed");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 2u, "a1 and b1 are left");
+
+  queue->PushFront (a4, hdrA);
+  queue->PeekByDestination (addrA, 10, &packets, &hdrs);
+  NS_TEST_ASSERT_MSG_EQ (packets.size (), 2u, "a4 and a1 are queued for A");
+  NS_TEST_EXPECT_MSG_EQ (packets[0], a4, "a4 was pushed in front of a1");
+  NS_TEST_EXPECT_MSG_EQ (packets[1], a1, "a1 follows a4");
+  queue->PeekByDestination (addrB, 10, &packets, &hdrs);
+  NS_TEST_ASSERT_MSG_EQ (packets.size (), 1u, "b1 is the only packet for B");
+  NS_TEST_EXPECT_MSG_EQ (packets[0], b1, "b1 is the only packet for B");
+
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), a4, "FIFO order");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), a1, "FIFO order");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (&out), b1, "FIFO order");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "every packet was dequeued");
+  Simulator::Destroy ();
+}
+
+void
+FullWifiMacQueueTest::DoRun (void)
+{
+  TestExpiry ();
+  TestPushFront ();
+  TestRemove ();
+  TestMaxSize ();
+  TestDestinations ();
+  TestPeekByDestination ();
+}
+
+class FullWifiMacQueueTestSuite : public TestSuite
+{
+public:
+  FullWifiMacQueueTestSuite ();
+};
+
+FullWifiMacQueueTestSuite::FullWifiMacQueueTestSuite ()
+  : TestSuite ("devices-wifi-mac-queue", UNIT)
+{
+  AddTestCase (new FullWifiMacQueueTest);
+}
+
+static FullWifiMacQueueTestSuite g_wifiMacQueueTestSuite;
+
+} // namespace ns3
@@ -29,16 +29,28 @@
 //#include "ns3/propagation-loss-model.h"
 #include "ns3/full-error-rate-model.h"
 #include "ns3/full-yans-error-rate-model.h"
+#include "ns3/full-nist-error-rate-model.h"
+#include "ns3/full-constant-rate-wifi-manager.h"
 //#include "ns3/constant-position-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/object-factory.h"
 #include "ns3/full-dca-txop.h"
+#include "ns3/full-wifi-mac-queue.h"
+#include "ns3/full-return-packet-policy.h"
 #include "ns3/full-mac-rx-middle.h"
+#include "ns3/full-ctrl-frame-factory.h"
+#include "ns3/full-wifi-mac-trailer.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/full-duplex-library.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/flow-id-tag.h"
+#include <cmath>
+#include <fstream>
 
 namespace ns3 {
 
@@ -428,6 +440,524 @@ FullBug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Compare the far-field aggregation of FullYansWifiChannel with the exact
+ * model on a CollisionExperiment-like setup: a receiver hears transmitter A
+ * close to its sensitivity while a distant transmitter B, below the
+ * FarFieldThreshold, sends simultaneously. A alone arrives 3.5 dB above
+ * the noise floor and is always received at 6 Mbps; the interference of B
+ * brings its SINR down to about 0.5 dB, where about a third of its packets
+ * are lost. Only the interference of B is approximated, so both modes
+ * should lose about as many packets of A.
+ */
+class FullFarFieldAggregationTest : public TestCase
+{
+public:
+  FullFarFieldAggregationTest ();
+
+  virtual void DoRun (void);
+private:
+  void RunOne (bool aggregate, bool sendB);
+  void SendA (void);
+  void SendB (void);
+  void Receive (Ptr<Packet> p, double snr, FullWifiMode mode, enum FullWifiPreamble preamble);
+
+  Ptr<FullYansWifiPhy> m_txA;
+  Ptr<FullYansWifiPhy> m_txB;
+  uint32_t m_flowIdA;
+  uint32_t m_flowIdB;
+  uint32_t m_receivedA;
+  uint32_t m_receivedB;
+  uint32_t m_nPackets;
+};
+
+FullFarFieldAggregationTest::FullFarFieldAggregationTest ()
+  : TestCase ("Far-field interference aggregation against the exact model"),
+    m_nPackets (200)
+{
+}
+
+void
+FullFarFieldAggregationTest::SendA (void)
+{
+  Ptr<Packet> p = Create<Packet> (2304);
+  p->AddByteTag (FlowIdTag (m_flowIdA));
+  m_txA->SendPacket (p, FullWifiMode ("OfdmRate6Mbps"), FULL_WIFI_PREAMBLE_SHORT, 0);
+}
+
+void
+FullFarFieldAggregationTest::SendB (void)
+{
+  Ptr<Packet> p = Create<Packet> (2304);
+  p->AddByteTag (FlowIdTag (m_flowIdB));
+  m_txB->SendPacket (p, FullWifiMode ("OfdmRate6Mbps"), FULL_WIFI_PREAMBLE_SHORT, 0);
+}
+
+void
+FullFarFieldAggregationTest::Receive (Ptr<Packet> p, double snr, FullWifiMode mode, enum FullWifiPreamble preamble)
+{
+  FlowIdTag tag;
+  p->FindFirstMatchingByteTag (tag);
+  if (tag.GetFlowId () == m_flowIdA)
+    {
+      m_receivedA++;
+    }
+  else if (tag.GetFlowId () == m_flowIdB)
+    {
+      m_receivedB++;
+    }
+}
+
+void
+FullFarFieldAggregationTest::RunOne (bool aggregate, bool sendB)
+{
+  m_receivedA = 0;
+  m_receivedB = 0;
+  m_flowIdA = FlowIdTag::AllocateFlowId ();
+  m_flowIdB = FlowIdTag::AllocateFlowId ();
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<FullYansWifiChannel> channel = CreateObject<FullYansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetAttribute ("EnableFarFieldAggregation", BooleanValue (aggregate));
+  channel->SetAttribute ("FarFieldThreshold", DoubleValue (-92.0));
+
+  Ptr<MobilityModel> posTxA = CreateObject<ConstantPositionMobilityModel> ();
+  posTxA->SetPosition (Vector (115.0, 0.0, 0.0));
+  Ptr<MobilityModel> posTxB = CreateObject<ConstantPositionMobilityModel> ();
+  posTxB->SetPosition (Vector (-150.0, 0.0, 0.0));
+  Ptr<MobilityModel> posRx = CreateObject<ConstantPositionMobilityModel> ();
+  posRx->SetPosition (Vector (0.0, 0.0, 0.0));
+
+  m_txA = CreateObject<FullYansWifiPhy> ();
+  m_txB = CreateObject<FullYansWifiPhy> ();
+  Ptr<FullYansWifiPhy> rx = CreateObject<FullYansWifiPhy> ();
+  Ptr<FullErrorRateModel> error = CreateObject<FullYansErrorRateModel> ();
+  m_txA->SetErrorRateModel (error);
+  m_txB->SetErrorRateModel (error);
+  rx->SetErrorRateModel (error);
+  m_txA->SetChannel (channel);
+  m_txB->SetChannel (channel);
+  rx->SetChannel (channel);
+  m_txA->SetMobility (posTxA);
+  m_txB->SetMobility (posTxB);
+  rx->SetMobility (posRx);
+  rx->SetReceiveOkCallback (MakeCallback (&FullFarFieldAggregationTest::Receive, this));
+  // draw the same reception errors in both modes
+  rx->AssignStreams (1);
+
+  for (uint32_t i = 0; i < m_nPackets; ++i)
+    {
+      Simulator::Schedule (Seconds (i), &FullFarFieldAggregationTest::SendA, this);
+      if (sendB)
+        {
+          Simulator::Schedule (Seconds (i), &FullFarFieldAggregationTest::SendB, this);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_txA = 0;
+  m_txB = 0;
+}
+
+void
+FullFarFieldAggregationTest::DoRun (void)
+{
+  RunOne (false, false);
+  uint32_t aloneA = m_receivedA;
+  RunOne (false, true);
+  uint32_t exactA = m_receivedA;
+  RunOne (true, true);
+  uint32_t aggregateA = m_receivedA;
+
+  NS_TEST_ASSERT_MSG_EQ (m_receivedB, 0u, "far-field packets must not be received");
+  NS_TEST_ASSERT_MSG_EQ (aloneA, m_nPackets, "A alone should always be received");
+  NS_TEST_ASSERT_MSG_GT (exactA, 0u, "the interference of B should not lose every packet of A");
+  NS_TEST_ASSERT_MSG_LT (exactA, m_nPackets, "the interference of B should lose packets of A");
+  NS_TEST_ASSERT_MSG_LT (aggregateA, aloneA, "the aggregated interference of B is ignored");
+  double difference = std::abs ((double)exactA - (double)aggregateA);
+  NS_TEST_ASSERT_MSG_LT (difference, 0.15 * m_nPackets,
+                         "aggregate mode received " << aggregateA << " packets, exact mode " << exactA);
+}
+
+//-----------------------------------------------------------------------------
+class FullDuplexConflictMapTest : public TestCase
+{
+public:
+  FullDuplexConflictMapTest ();
+
+  virtual void DoRun (void);
+private:
+  void CreateOne (Vector pos, Ptr<FullYansWifiChannel> channel);
+  Mac48Address GetAddress (uint32_t i) const;
+  Ptr<ForwardQueue> GetForwardQueue (uint32_t i) const;
+  void Build (std::string positionFileName);
+
+  NodeContainer m_nodes;
+  Ptr<LogDistancePropagationLossModel> m_loss;
+};
+
+FullDuplexConflictMapTest::FullDuplexConflictMapTest ()
+  : TestCase ("Duplex conflict map of a fixed topology")
+{
+}
+
+void
+FullDuplexConflictMapTest::CreateOne (Vector pos, Ptr<FullYansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<FullWifiNetDevice> dev = CreateObject<FullWifiNetDevice> ();
+  Ptr<FullWifiMac> mac = CreateObject<FullAdhocWifiMac> ();
+  mac->ConfigureStandard (FULL_WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<FullYansWifiPhy> phy = CreateObject<FullYansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<FullNistErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (FULL_WIFI_PHY_STANDARD_80211a);
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (CreateObject<FullConstantRateWifiManager> ());
+  node->AddDevice (dev);
+  m_nodes.Add (node);
+}
+
+Mac48Address
+FullDuplexConflictMapTest::GetAddress (uint32_t i) const
+{
+  return Mac48Address::ConvertFrom (m_nodes.Get (i)->GetDevice (0)->GetAddress ());
+}
+
+Ptr<ForwardQueue>
+FullDuplexConflictMapTest::GetForwardQueue (uint32_t i) const
+{
+  Ptr<FullWifiNetDevice> dev = DynamicCast<FullWifiNetDevice> (m_nodes.Get (i)->GetDevice (0));
+  PointerValue queue;
+  dev->GetMac ()->GetAttribute ("ForwardQueue", queue);
+  return queue.Get<ForwardQueue> ();
+}
+
+void
+FullDuplexConflictMapTest::Build (std::string positionFileName)
+{
+  std::vector<std::pair<Ptr<Node>, Ptr<Node> > > flows;
+  flows.push_back (std::make_pair (m_nodes.Get (0), m_nodes.Get (1)));
+  flows.push_back (std::make_pair (m_nodes.Get (1), m_nodes.Get (0)));
+  // any SINR above 0 dB is a candidate, ordered by success rate
+  SetDuplexConflictMap (m_nodes, flows, m_loss, 16.0206, 0, 0,
+                        "OfdmRate54Mbps", 1000, positionFileName);
+}
+
+void
+FullDuplexConflictMapTest::DoRun (void)
+{
+  Ptr<FullYansWifiChannel> channel = CreateObject<FullYansWifiChannel> ();
+  m_loss = CreateObject<LogDistancePropagationLossModel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (m_loss);
+
+  // 0 sends to 1; 2 hears 1 at 31 dB over 0, 3 at 8.7 dB
+  CreateOne (Vector (-100.0, 0.0, 0.0), channel);
+  CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  CreateOne (Vector (10.0, 0.0, 0.0), channel);
+  CreateOne (Vector (0.0, 60.0, 0.0), channel);
+
+  Build ("");
+  NS_TEST_ASSERT_MSG_EQ (GetForwardQueue (1)->Size (), 1u, "one map per transmitter to node 1");
+  ForwardMap *map = GetForwardQueue (1)->GetForwardMap (GetAddress (0));
+  NS_TEST_ASSERT_MSG_EQ (map != 0, true, "no map for the flow from node 0");
+  NS_TEST_ASSERT_MSG_EQ (map->Size (), 2u, "nodes 2 and 3 are candidates");
+  NS_TEST_EXPECT_MSG_EQ (map->GetQueue ()[0].add, GetAddress (2), "the strongest candidate comes first");
+  NS_TEST_EXPECT_MSG_EQ (map->GetQueue ()[1].add, GetAddress (3), "the weakest candidate comes last");
+  NS_TEST_EXPECT_MSG_LT (map->GetQueue ()[0].priority, map->GetQueue ()[1].priority, "priorities out of order");
+  map = GetForwardQueue (0)->GetForwardMap (GetAddress (1));
+  NS_TEST_ASSERT_MSG_EQ (map != 0, true, "no map for the flow from node 1");
+  NS_TEST_EXPECT_MSG_EQ (map->Size (), 0u, "node 1 drowns every candidate of node 0");
+  NS_TEST_EXPECT_MSG_EQ (GetForwardQueue (2)->Size (), 0u, "node 2 receives no flow");
+
+  // the cache is written next to the position file and read back as long
+  // as its key matches
+  std::string positionFileName = CreateTempDirFilename ("conflict-map-positions.txt");
+  std::ofstream positions (positionFileName.c_str ());
+  positions << "-100 0\n0 0\n10 0\n0 60\n";
+  positions.close ();
+  Build (positionFileName);
+  std::string cacheFileName = positionFileName + ".conflict";
+  std::ifstream cache (cacheFileName.c_str ());
+  std::string key;
+  NS_TEST_ASSERT_MSG_EQ (std::getline (cache, key).good (), true, "no conflict map cache");
+  cache.close ();
+  std::ofstream tampered (cacheFileName.c_str ());
+  tampered << key << "\n" << "0 3 0.25\n0 2 0.5\n";
+  tampered.close ();
+  Build (positionFileName);
+  map = GetForwardQueue (1)->GetForwardMap (GetAddress (0));
+  NS_TEST_ASSERT_MSG_EQ (map != 0, true, "no map for the flow from node 0");
+  NS_TEST_ASSERT_MSG_EQ (map->Size (), 2u, "cached map not read back");
+  NS_TEST_EXPECT_MSG_EQ (map->GetQueue ()[0].add, GetAddress (3), "cached map not read back");
+  NS_TEST_EXPECT_MSG_EQ_TOL (map->GetQueue ()[0].priority, 0.25, 1e-12, "cached priority not read back");
+
+  // an attribute of the loss model is part of the key
+  m_loss->SetAttribute ("Exponent", DoubleValue (3.5));
+  Build (positionFileName);
+  map = GetForwardQueue (1)->GetForwardMap (GetAddress (0));
+  NS_TEST_ASSERT_MSG_EQ (map != 0, true, "no map for the flow from node 0");
+  NS_TEST_EXPECT_MSG_EQ (map->GetQueue ()[0].add, GetAddress (2), "stale cache read after a loss model change");
+
+  Simulator::Destroy ();
+  m_nodes = NodeContainer ();
+  m_loss = 0;
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * A sends a long frame at 54 Mbps to B, whose station manager sends to A
+ * at 6 Mbps. B must size its return packet candidates in its own data mode
+ * and pick the longest one which fits in what is left of the frame of A.
+ */
+class FullReturnPacketSelectionTest : public TestCase
+{
+public:
+  FullReturnPacketSelectionTest ();
+
+  virtual void DoRun (void);
+private:
+  Ptr<FullWifiNetDevice> CreateOne (Vector pos, Ptr<FullYansWifiChannel> channel, std::string dataMode);
+  Ptr<FullWifiMacQueue> GetQueue (Ptr<FullWifiNetDevice> dev) const;
+  void Send (Ptr<FullWifiNetDevice> from, Ptr<FullWifiNetDevice> to);
+  void NotifyOverlap (double overlap);
+
+  Ptr<FullWifiMacQueue> m_queue;
+  Mac48Address m_returnTo;
+  uint32_t m_nOverlaps;
+  double m_overlap;
+  std::vector<uint32_t> m_leftSizes;
+};
+
+FullReturnPacketSelectionTest::FullReturnPacketSelectionTest ()
+  : TestCase ("Return packet sized in the mode it is sent with"),
+    m_nOverlaps (0),
+    m_overlap (0)
+{
+}
+
+Ptr<FullWifiNetDevice>
+FullReturnPacketSelectionTest::CreateOne (Vector pos, Ptr<FullYansWifiChannel> channel, std::string dataMode)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<FullWifiNetDevice> dev = CreateObject<FullWifiNetDevice> ();
+  Ptr<FullWifiMac> mac = CreateObject<FullAdhocWifiMac> ();
+  mac->ConfigureStandard (FULL_WIFI_PHY_STANDARD_80211a);
+  mac->SetAttribute ("EnableReturnPacket", BooleanValue (true));
+  mac->SetAttribute ("ReturnPacketPolicy", PointerValue (CreateObject<FullBestFitReturnPacketPolicy> ()));
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<FullYansWifiPhy> phy = CreateObject<FullYansWifiPhy> ();
+  phy->SetErrorRateModel (CreateObject<FullNistErrorRateModel> ());
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (node);
+  phy->ConfigureStandard (FULL_WIFI_PHY_STANDARD_80211a);
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (CreateObjectWithAttributes<FullConstantRateWifiManager>
+                                  ("DataMode", StringValue (dataMode)));
+  node->AddDevice (dev);
+  return dev;
+}
+
+Ptr<FullWifiMacQueue>
+FullReturnPacketSelectionTest::GetQueue (Ptr<FullWifiNetDevice> dev) const
+{
+  PointerValue dca;
+  dev->GetMac ()->GetAttribute ("DcaTxop", dca);
+  PointerValue queue;
+  dca.Get<FullDcaTxop> ()->GetAttribute ("Queue", queue);
+  return queue.Get<FullWifiMacQueue> ();
+}
+
+void
+FullReturnPacketSelectionTest::Send (Ptr<FullWifiNetDevice> from, Ptr<FullWifiNetDevice> to)
+{
+  from->Send (Create<Packet> (2000), to->GetAddress (), 1);
+}
+
+void
+FullReturnPacketSelectionTest::NotifyOverlap (double overlap)
+{
+  if (m_nOverlaps++ > 0)
+    {
+      return;
+    }
+  m_overlap = overlap;
+  std::vector<Ptr<const Packet> > packets;
+  std::vector<FullWifiMacHeader> hdrs;
+  m_queue->PeekByDestination (m_returnTo, 10, &packets, &hdrs);
+  for (uint32_t i = 0; i < packets.size (); i++)
+    {
+      m_leftSizes.push_back (packets[i]->GetSize ());
+    }
+}
+
+void
+FullReturnPacketSelectionTest::DoRun (void)
+{
+  Ptr<FullYansWifiChannel> channel = CreateObject<FullYansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  Ptr<FullWifiNetDevice> a = CreateOne (Vector (0.0, 0.0, 0.0), channel, "OfdmRate54Mbps");
+  Ptr<FullWifiNetDevice> b = CreateOne (Vector (5.0, 0.0, 0.0), channel, "OfdmRate6Mbps");
+
+  // queued behind the back of the DCF of B, so that B only sends them as
+  // return packets. About 300us are left of the frame of A once its header
+  // is received: at 6 Mbps, the 150 bytes packet is the longest which fits,
+  // while the 400 bytes one would fit at the 54 Mbps of A.
+  m_queue = GetQueue (b);
+  m_returnTo = Mac48Address::ConvertFrom (a->GetAddress ());
+  FullWifiMacHeader hdr;
+  hdr.SetType (FULL_WIFI_MAC_DATA);
+  hdr.SetAddr1 (m_returnTo);
+  hdr.SetAddr2 (Mac48Address::ConvertFrom (b->GetAddress ()));
+  hdr.SetAddr3 (Mac48Address::ConvertFrom (b->GetAddress ()));
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  m_queue->Enqueue (Create<Packet> (400), hdr);
+  m_queue->Enqueue (Create<Packet> (100), hdr);
+  m_queue->Enqueue (Create<Packet> (150), hdr);
+
+  PointerValue dca;
+  b->GetMac ()->GetAttribute ("DcaTxop", dca);
+  dca.Get<FullDcaTxop> ()->TraceConnectWithoutContext
+    ("ReturnPacketOverlap", MakeCallback (&FullReturnPacketSelectionTest::NotifyOverlap, this));
+
+  Simulator::Schedule (Seconds (1.0), &FullReturnPacketSelectionTest::Send, this, a, b);
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_GT (m_nOverlaps, 0u, "no return packet was selected");
+  NS_TEST_ASSERT_MSG_EQ (m_leftSizes.size (), 2u, "one return packet is selected");
+  NS_TEST_EXPECT_MSG_EQ (m_leftSizes[0], 400u, "the 400 bytes packet does not fit at 6 Mbps");
+  NS_TEST_EXPECT_MSG_EQ (m_leftSizes[1], 100u, "the 150 bytes packet fits best");
+  NS_TEST_EXPECT_MSG_GT (m_overlap, 0.8, "the return packet covers most of the frame of A");
+  NS_TEST_EXPECT_MSG_LT (m_overlap, 1.0, "the return packet is shorter than the frame of A");
+
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+//-----------------------------------------------------------------------------
+class FullReturnPacketPolicyTest : public TestCase
+{
+public:
+  FullReturnPacketPolicyTest () : TestCase ("Return packet selection policies")
+  {
+  }
+  virtual void DoRun (void)
+  {
+    std::vector<Time> durations;
+    durations.push_back (MicroSeconds (900));
+    durations.push_back (MicroSeconds (300));
+    durations.push_back (MicroSeconds (450));
+    durations.push_back (MicroSeconds (480));
+
+    Ptr<FullReturnPacketPolicy> first = CreateObject<FullFirstReturnPacketPolicy> ();
+    NS_TEST_EXPECT_MSG_EQ (first->Select (durations, MicroSeconds (500)), 0u, "first is always the oldest");
+
+    Ptr<FullReturnPacketPolicy> bestFit = CreateObject<FullBestFitReturnPacketPolicy> ();
+    NS_TEST_EXPECT_MSG_EQ (bestFit->Select (durations, MicroSeconds (500)), 3u, "longest packet which fits");
+    NS_TEST_EXPECT_MSG_EQ (bestFit->Select (durations, MicroSeconds (200)), 1u, "shortest packet if none fits");
+
+    Ptr<FullReturnPacketPolicy> firstFit = CreateObjectWithAttributes<FullFirstFitReturnPacketPolicy>
+        ("Slack", TimeValue (MicroSeconds (60)));
+    NS_TEST_EXPECT_MSG_EQ (firstFit->Select (durations, MicroSeconds (500)), 2u, "first packet within the slack");
+    NS_TEST_EXPECT_MSG_EQ (firstFit->Select (durations, MicroSeconds (1000)), 0u, "best fit outside of the slack");
+  }
+};
+
+//-----------------------------------------------------------------------------
+/**
+ * The frames of FullCtrlFrameFactory must hold the bytes which AddHeader
+ * and AddTrailer would produce, and the same header once removed.
+ */
+class FullCtrlFrameFactoryTest : public TestCase
+{
+public:
+  FullCtrlFrameFactoryTest ()
+    : TestCase ("Control frames built from templates")
+  {
+  }
+
+  virtual void DoRun (void)
+  {
+    FullCtrlFrameFactory factory;
+    const enum FullWifiMacType types[] = { FULL_WIFI_MAC_CTL_ACK, FULL_WIFI_MAC_CTL_CTS,
+                                           FULL_WIFI_MAC_CTL_RTS, FULL_WIFI_MAC_BUSY_TONE };
+    for (uint32_t t = 0; t < sizeof (types) / sizeof (types[0]); t++)
+      {
+        // a second frame of a type must not keep the fields of the first
+        for (uint32_t n = 1; n <= 2; n++)
+          {
+            FullWifiMacHeader hdr = factory.GetHeader (types[t]);
+            hdr.SetAddr1 (Mac48Address::Allocate ());
+            hdr.SetDuration (MicroSeconds (44 * n));
+            if (hdr.IsRts () || hdr.IsBusyTone ())
+              {
+                hdr.SetAddr2 (Mac48Address::Allocate ());
+              }
+            if (hdr.IsBusyTone ())
+              {
+                hdr.SetAddr3 (Mac48Address::Allocate ());
+                hdr.SetSequenceNumber (100 * n);
+              }
+            Check (factory.Create (hdr), hdr);
+          }
+      }
+  }
+
+private:
+  void Check (Ptr<Packet> frame, const FullWifiMacHeader &hdr)
+  {
+    Ptr<Packet> expected = Create<Packet> ();
+    expected->AddHeader (hdr);
+    FullWifiMacTrailer fcs;
+    expected->AddTrailer (fcs);
+    NS_TEST_ASSERT_MSG_EQ (frame->GetSize (), expected->GetSize (), "wrong size of " << hdr.GetTypeString ());
+    std::vector<uint8_t> frameBytes (frame->GetSize ());
+    std::vector<uint8_t> expectedBytes (expected->GetSize ());
+    frame->CopyData (&frameBytes[0], frameBytes.size ());
+    expected->CopyData (&expectedBytes[0], expectedBytes.size ());
+    for (uint32_t i = 0; i < frameBytes.size (); i++)
+      {
+        NS_TEST_EXPECT_MSG_EQ ((uint32_t)frameBytes[i], (uint32_t)expectedBytes[i],
+                               "byte " << i << " of " << hdr.GetTypeString ());
+      }
+
+    FullWifiMacHeader removed;
+    frame->RemoveHeader (removed);
+    NS_TEST_EXPECT_MSG_EQ (removed.GetType (), hdr.GetType (), "wrong type");
+    NS_TEST_EXPECT_MSG_EQ (removed.GetAddr1 (), hdr.GetAddr1 (), "wrong addr1 of " << hdr.GetTypeString ());
+    NS_TEST_EXPECT_MSG_EQ (removed.GetDuration (), hdr.GetDuration (), "wrong duration of " << hdr.GetTypeString ());
+    if (hdr.IsRts () || hdr.IsBusyTone ())
+      {
+        NS_TEST_EXPECT_MSG_EQ (removed.GetAddr2 (), hdr.GetAddr2 (), "wrong addr2 of " << hdr.GetTypeString ());
+      }
+    if (hdr.IsBusyTone ())
+      {
+        NS_TEST_EXPECT_MSG_EQ (removed.GetAddr3 (), hdr.GetAddr3 (), "wrong addr3");
+        NS_TEST_EXPECT_MSG_EQ (removed.GetSequenceNumber (), hdr.GetSequenceNumber (), "wrong sequence number");
+      }
+  }
+};
+
 //-----------------------------------------------------------------------------
 
 class FullWifiTestSuite : public TestSuite
@@ -443,6 +973,11 @@ FullWifiTestSuite::FullWifiTestSuite ()
   AddTestCase (new FullQosUtilsIsOldPacketTest);
   AddTestCase (new FullInterferenceHelperSequenceTest); // Bug 991
   AddTestCase (new FullBug555TestCase); // Bug 555
+  AddTestCase (new FullFarFieldAggregationTest);
+  AddTestCase (new FullDuplexConflictMapTest);
+  AddTestCase (new FullReturnPacketPolicyTest);
+  AddTestCase (new FullReturnPacketSelectionTest);
+  AddTestCase (new FullCtrlFrameFactoryTest);
 }
 
 static FullWifiTestSuite g_wifiTestSuite;